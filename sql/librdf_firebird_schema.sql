@@ -105,6 +105,19 @@ CREATE INDEX IDX_TRIPLE_O_BLANK ON TRIPLE (O_BLANK);
 CREATE INDEX IDX_TRIPLE_O_LITERAL ON TRIPLE (O_LITERAL);
 CREATE INDEX IDX_TRIPLE_C_URI ON TRIPLE (C_URI);
 
+/* optional composite indexes, created instead of the single column indexes
+   above when the storage option composite_indexes='yes' is used */
+/*
+CREATE INDEX IDX_TRIPLE_SPOC ON TRIPLE
+    (S_URI, S_BLANK, P_URI, O_URI, O_BLANK, O_LITERAL, C_URI);
+CREATE INDEX IDX_TRIPLE_POS ON TRIPLE
+    (P_URI, O_URI, O_BLANK, O_LITERAL, S_URI, S_BLANK);
+CREATE INDEX IDX_TRIPLE_OSP ON TRIPLE
+    (O_URI, O_BLANK, O_LITERAL, S_URI, S_BLANK, P_URI);
+CREATE INDEX IDX_TRIPLE_CSPO ON TRIPLE
+    (C_URI, S_URI, S_BLANK, P_URI, O_URI, O_BLANK, O_LITERAL);
+*/
+
 
 /* friendly view of the triples */
 CREATE VIEW STATEMENTS_N3 as
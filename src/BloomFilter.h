@@ -0,0 +1,123 @@
+/*
+ * BloomFilter.h - blocked bloom filter for fast negative lookups
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#ifndef BLOOMFILTER_H_
+#define BLOOMFILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace cache
+{
+
+/**
+ * Bloom filter over 64 bit hashes. Each hash sets one bit in each of the 8
+ * words of a single 64 byte block, so a lookup touches one cache line. With
+ * 16 bits per item the false positive rate is below 0.1%.
+ */
+class BlockedBloomFilter final
+{
+public:
+    static constexpr size_t BLOCK_WORDS = 8;
+
+    /** an empty filter sized for capacity items */
+    explicit BlockedBloomFilter(size_t capacity = 0,
+                                unsigned int bitsPerItem = 16)
+            : capacity_(capacity), items_(0),
+              words_(blockCount(capacity, bitsPerItem) * BLOCK_WORDS)
+    {
+    }
+
+    /** a filter restored from the words() of another one */
+    BlockedBloomFilter(size_t capacity, size_t items,
+                       std::vector<uint64_t> &&words)
+            : capacity_(capacity), items_(items), words_(std::move(words))
+    {
+    }
+
+    void add(uint64_t hash)
+    {
+        uint64_t *block = &words_[blockIndex(hash) * BLOCK_WORDS];
+        const uint64_t bits = bitSelector(hash);
+        for (size_t i = 0; i != BLOCK_WORDS; ++i) {
+            block[i] |= 1ULL << ((bits >> (6 * i)) & 63);
+        }
+        ++items_;
+    }
+
+    /** false if hash was definitely never added */
+    bool mayContain(uint64_t hash) const
+    {
+        const uint64_t *block = &words_[blockIndex(hash) * BLOCK_WORDS];
+        const uint64_t bits = bitSelector(hash);
+        for (size_t i = 0; i != BLOCK_WORDS; ++i) {
+            if (!(block[i] & (1ULL << ((bits >> (6 * i)) & 63)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** more items were added than the filter was sized for */
+    bool full() const
+    {
+        return items_ > capacity_;
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t items() const
+    {
+        return items_;
+    }
+
+    const std::vector<uint64_t> &words() const
+    {
+        return words_;
+    }
+
+private:
+    static size_t blockCount(size_t capacity, unsigned int bitsPerItem)
+    {
+        const size_t blockBits = BLOCK_WORDS * 64;
+        const size_t n = (capacity * bitsPerItem + blockBits - 1) / blockBits;
+        return n ? n : 1;
+    }
+
+    size_t blockIndex(uint64_t hash) const
+    {
+        // map the high 32 bits onto [0, blocks) without a division
+        const uint64_t blocks = words_.size() / BLOCK_WORDS;
+        return (size_t) (((hash >> 32) * blocks) >> 32);
+    }
+
+    static uint64_t bitSelector(uint64_t hash)
+    {
+        // 48 bits independent of the block index, 6 per word
+        return (hash ^ (hash >> 29)) * 0xBF58476D1CE4E5B9ULL;
+    }
+
+    size_t capacity_;
+    size_t items_;
+    std::vector<uint64_t> words_;
+};
+
+} /* namespace cache */
+
+#endif /* BLOOMFILTER_H_ */
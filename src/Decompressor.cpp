@@ -0,0 +1,270 @@
+/*
+ * Decompressor.cpp - decompress gzip and zstd files on a separate thread
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+
+#include "Decompressor.h"
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+#include <stdexcept>
+#include <string.h>
+#include <vector>
+
+#ifdef RDF_FIREBIRD_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef RDF_FIREBIRD_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace rdf
+{
+
+/** bytes of compressed input read at once */
+static const size_t INPUT_SIZE = 128 * 1024;
+
+/** thrown by the decompression thread when the reader went away */
+struct Cancelled
+{
+};
+
+static bool ends_with(const char *s, const char *suffix)
+{
+    const size_t len = strlen(s);
+    const size_t suffixLen = strlen(suffix);
+    return len >= suffixLen && strcmp(s + len - suffixLen, suffix) == 0;
+}
+
+Compression file_compression(const char *fileName)
+{
+    if (ends_with(fileName, ".gz")) {
+        return COMPRESSION_GZIP;
+    }
+    if (ends_with(fileName, ".zst")) {
+        return COMPRESSION_ZSTD;
+    }
+    return COMPRESSION_NONE;
+}
+
+Decompressor::Decompressor(const char *fileName, Compression compression) :
+        file_(nullptr),
+        compression_(compression),
+        pending_(),
+        mutex_(),
+        notEmpty_(),
+        notFull_(),
+        chunks_(),
+        done_(false),
+        cancelled_(false),
+        error_(),
+        thread_()
+{
+    const char *unsupported = nullptr;
+    switch (compression) {
+    case COMPRESSION_NONE:
+        unsupported = "not compressed";
+        break;
+    case COMPRESSION_GZIP:
+#ifndef RDF_FIREBIRD_HAVE_ZLIB
+        unsupported = "built without gzip support";
+#endif
+        break;
+    case COMPRESSION_ZSTD:
+#ifndef RDF_FIREBIRD_HAVE_ZSTD
+        unsupported = "built without zstd support";
+#endif
+        break;
+    }
+    if (unsupported) {
+        throw std::runtime_error(std::string(fileName) + ": " + unsupported);
+    }
+
+    file_ = fopen(fileName, "rb");
+    if (!file_) {
+        throw std::runtime_error(std::string("Failed to open ") + fileName +
+                                 ": " + strerror(errno));
+    }
+    pending_.reserve(CHUNK_SIZE);
+    thread_ = std::thread(&Decompressor::run, this);
+}
+
+Decompressor::~Decompressor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+    }
+    notFull_.notify_all();
+    thread_.join();
+    fclose(file_);
+}
+
+bool Decompressor::next(std::string &chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    notEmpty_.wait(lock, [this] { return !chunks_.empty() || done_; });
+    if (chunks_.empty()) {
+        if (!error_.empty()) {
+            throw std::runtime_error(error_);
+        }
+        return false;
+    }
+    chunk.swap(chunks_.front());
+    chunks_.pop_front();
+    lock.unlock();
+    notFull_.notify_one();
+    return true;
+}
+
+void Decompressor::run()
+{
+    try {
+        if (compression_ == COMPRESSION_GZIP) {
+            inflateGzip();
+        } else {
+            inflateZstd();
+        }
+        flush();
+    } catch (Cancelled&) {
+        // the reader doesn't want the rest
+    } catch (std::exception &e) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = e.what();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    notEmpty_.notify_all();
+}
+
+void Decompressor::emit(const char *data, size_t size)
+{
+    while (size) {
+        const size_t n = std::min(size, CHUNK_SIZE - pending_.size());
+        pending_.append(data, n);
+        data += n;
+        size -= n;
+        if (pending_.size() == CHUNK_SIZE) {
+            flush();
+        }
+    }
+}
+
+/** queue the pending chunk, wait while the queue is full */
+void Decompressor::flush()
+{
+    if (pending_.empty()) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] {
+            return chunks_.size() < MAX_CHUNKS || cancelled_;
+        });
+        if (cancelled_) {
+            throw Cancelled();
+        }
+        chunks_.push_back(std::move(pending_));
+    }
+    notEmpty_.notify_one();
+    pending_.clear();
+    pending_.reserve(CHUNK_SIZE);
+}
+
+void Decompressor::inflateGzip()
+{
+#ifdef RDF_FIREBIRD_HAVE_ZLIB
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    // 32: detect the gzip or zlib header
+    if (inflateInit2(&zs, 15 + 32) != Z_OK) {
+        throw std::runtime_error("Failed to initialize zlib");
+    }
+    std::unique_ptr<z_stream, int (*)(z_streamp)> guard(&zs, &inflateEnd);
+
+    std::vector<unsigned char> in(INPUT_SIZE);
+    std::vector<unsigned char> out(CHUNK_SIZE / 4);
+    bool ended = false;
+    for (;;) {
+        if (zs.avail_in == 0) {
+            const size_t n = fread(in.data(), 1, in.size(), file_);
+            if (n == 0) {
+                break;
+            }
+            zs.next_in = in.data();
+            zs.avail_in = (uInt) n;
+        }
+        zs.next_out = out.data();
+        zs.avail_out = (uInt) out.size();
+        const int rc = inflate(&zs, Z_NO_FLUSH);
+        emit((const char*) out.data(), out.size() - zs.avail_out);
+        if (rc == Z_STREAM_END) {
+            // a file may hold several gzip members
+            ended = true;
+            inflateReset(&zs);
+        } else if (rc == Z_OK || rc == Z_BUF_ERROR) {
+            ended = false;
+        } else {
+            throw std::runtime_error(std::string("Invalid gzip data: ") +
+                                     (zs.msg ? zs.msg : "unknown error"));
+        }
+    }
+    if (ferror(file_)) {
+        throw std::runtime_error("Failed to read the compressed file");
+    }
+    if (!ended) {
+        throw std::runtime_error("Truncated gzip data");
+    }
+#endif
+}
+
+void Decompressor::inflateZstd()
+{
+#ifdef RDF_FIREBIRD_HAVE_ZSTD
+    std::unique_ptr<ZSTD_DStream, size_t (*)(ZSTD_DStream*)> ds(
+                                    ZSTD_createDStream(), &ZSTD_freeDStream);
+    if (!ds || ZSTD_isError(ZSTD_initDStream(ds.get()))) {
+        throw std::runtime_error("Failed to initialize zstd");
+    }
+
+    std::vector<char> in(ZSTD_DStreamInSize());
+    std::vector<char> out(ZSTD_DStreamOutSize());
+    size_t last = 0;
+    size_t n;
+    while ((n = fread(in.data(), 1, in.size(), file_)) != 0) {
+        ZSTD_inBuffer input = { in.data(), n, 0 };
+        // until the input is used up and the output no longer fills up
+        for (;;) {
+            ZSTD_outBuffer output = { out.data(), out.size(), 0 };
+            last = ZSTD_decompressStream(ds.get(), &output, &input);
+            if (ZSTD_isError(last)) {
+                throw std::runtime_error(std::string("Invalid zstd data: ") +
+                                         ZSTD_getErrorName(last));
+            }
+            emit(out.data(), output.pos);
+            if (input.pos == input.size && output.pos < output.size) {
+                break;
+            }
+        }
+    }
+    if (ferror(file_)) {
+        throw std::runtime_error("Failed to read the compressed file");
+    }
+    if (last != 0) {
+        throw std::runtime_error("Truncated zstd data");
+    }
+#endif
+}
+
+} /* namespace rdf */
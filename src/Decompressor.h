@@ -0,0 +1,95 @@
+/*
+ * Decompressor.h - decompress gzip and zstd files on a separate thread
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#ifndef DECOMPRESSOR_H_
+#define DECOMPRESSOR_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace rdf
+{
+
+enum Compression : int
+{
+    COMPRESSION_NONE = 0,
+    /** .gz, requires zlib (RDF_FIREBIRD_HAVE_ZLIB) */
+    COMPRESSION_GZIP,
+    /** .zst, requires libzstd (RDF_FIREBIRD_HAVE_ZSTD) */
+    COMPRESSION_ZSTD
+};
+
+/** the compression of a file, chosen by its extension */
+Compression file_compression(const char *fileName);
+
+/**
+ * Decompress a file on a thread of its own, which hands chunks of
+ * CHUNK_SIZE bytes to the reader through a queue of at most MAX_CHUNKS, so
+ * that decompression overlaps the processing of the previous chunks and
+ * stops while the reader is behind.
+ */
+class Decompressor final
+{
+public:
+    static const size_t CHUNK_SIZE = 1 << 20;
+    static const size_t MAX_CHUNKS = 4;
+
+    /**
+     * Start decompressing, throw std::runtime_error if the file can't be
+     * opened or the compression isn't supported by this build.
+     */
+    Decompressor(const char *fileName, Compression compression);
+    ~Decompressor();
+
+    Decompressor(const Decompressor&) = delete;
+    Decompressor &operator=(const Decompressor&) = delete;
+
+    /**
+     * Replace chunk with the next chunk of decompressed data, return false
+     * at the end of the data. Throw std::runtime_error if the file can't be
+     * read or decompressed.
+     */
+    bool next(std::string &chunk);
+
+private:
+    void run();
+    void inflateGzip();
+    void inflateZstd();
+    void emit(const char *data, size_t size);
+    void flush();
+
+    FILE *file_;
+    const Compression compression_;
+    // the chunk being filled by the decompression thread
+    std::string pending_;
+
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<std::string> chunks_;
+    bool done_;
+    bool cancelled_;
+    std::string error_;
+
+    std::thread thread_;
+};
+
+} /* namespace rdf */
+
+#endif /* DECOMPRESSOR_H_ */
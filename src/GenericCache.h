@@ -33,7 +33,9 @@ template<typename KeyType,
 class GenericCache final
 {
 public:
-    GenericCache(GetValueFunc func) : generation_(0), dict_(), func_(func)
+    GenericCache(GetValueFunc func)
+            : generation_(0), dict_(), func_(func),
+              hits_(0), misses_(0), evictions_(0)
     {
     }
 
@@ -50,6 +52,7 @@ public:
         CdIterator i = dict_.find(key);
         if (i == dict_.end()) {
             // cache miss, do the hard work
+            misses_++;
             ValueType val = func_(key);
             if (val != NotFoundValue) {
                 return dict_.emplace(
@@ -60,11 +63,45 @@ public:
             }
         } else {
             // cache hit
+            hits_++;
             i->second.generation_ = generation_;
             return i->second.value_;
         }
     }
 
+    /** forget the cached value of key, e.g. after it was deleted */
+    void remove(const KeyType &key)
+    {
+        dict_.erase(key);
+    }
+
+    /** forget all cached values, e.g. after values were deleted */
+    void clear()
+    {
+        dict_.clear();
+    }
+
+    uint64_t hits() const
+    {
+        return hits_;
+    }
+
+    uint64_t misses() const
+    {
+        return misses_;
+    }
+
+    /** values dropped to trim the cache */
+    uint64_t evictions() const
+    {
+        return evictions_;
+    }
+
+    size_t size() const
+    {
+        return dict_.size();
+    }
+
 private:
 
     void removeOldItems()
@@ -88,6 +125,7 @@ private:
 
         std::nth_element(items.begin(), nthElem, items.end(), generationCompare);
 
+        evictions_ += items.end() - nthElem;
         for (auto i = nthElem; i != items.end(); ++i) {
             dict_.erase(*i);
         }
@@ -105,6 +143,9 @@ private:
     uint64_t generation_;
     CacheDict dict_;
     GetValueFunc func_;
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t evictions_;
 };
 
 } /* namespace cache */
@@ -0,0 +1,188 @@
+/*
+ * Metrics.h - operation counters and latency histograms
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+namespace metrics
+{
+
+/**
+ * Latency histogram with logarithmic buckets of linear sub-buckets (like
+ * HdrHistogram): values below 8 ns are exact, larger ones are kept with 8
+ * sub-buckets per power of two, i.e. within 12.5%, up to about an hour.
+ */
+class LatencyHistogram final
+{
+public:
+    static constexpr unsigned int SUB_BUCKET_BITS = 3;
+    static constexpr unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr unsigned int MAX_EXPONENT = 42;
+    static constexpr unsigned int BUCKETS =
+                (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    LatencyHistogram() : counts_(), count_(0), total_(0), max_(0)
+    {
+    }
+
+    void record(uint64_t ns)
+    {
+        counts_[bucketOf(ns)]++;
+        count_++;
+        total_ += ns;
+        if (ns > max_) {
+            max_ = ns;
+        }
+    }
+
+    uint64_t count() const
+    {
+        return count_;
+    }
+
+    /** sum of the recorded values in ns */
+    uint64_t total() const
+    {
+        return total_;
+    }
+
+    uint64_t max() const
+    {
+        return max_;
+    }
+
+    /** upper bound (in ns) of the values below which p (0-1) of them are */
+    uint64_t percentile(double p) const
+    {
+        if (count_ == 0) {
+            return 0;
+        }
+
+        uint64_t rank = (uint64_t) (p * (double) count_ + 0.5);
+        if (rank == 0) {
+            rank = 1;
+        }
+
+        uint64_t seen = 0;
+        for (unsigned int b = 0; b != BUCKETS; ++b) {
+            seen += counts_[b];
+            if (seen >= rank) {
+                const uint64_t limit = bucketLimit(b);
+                return limit < max_ ? limit : max_;
+            }
+        }
+        return max_;
+    }
+
+private:
+    static unsigned int bucketOf(uint64_t v)
+    {
+        if (v < SUB_BUCKETS) {
+            return (unsigned int) v;
+        }
+
+        unsigned int e = 63 - (unsigned int) __builtin_clzll(v);
+        if (e > MAX_EXPONENT) {
+            return BUCKETS - 1;
+        }
+        const unsigned int mantissa = (unsigned int)
+                    (v >> (e - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (e - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + mantissa;
+    }
+
+    /** the largest value of bucket b */
+    static uint64_t bucketLimit(unsigned int b)
+    {
+        if (b < SUB_BUCKETS) {
+            return b;
+        }
+        const unsigned int e = b / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+        const uint64_t mantissa = b % SUB_BUCKETS;
+        const unsigned int shift = e - SUB_BUCKET_BITS;
+        return ((SUB_BUCKETS + mantissa + 1) << shift) - 1;
+    }
+
+    uint64_t counts_[BUCKETS];
+    uint64_t count_;
+    uint64_t total_;
+    uint64_t max_;
+};
+
+/** a lazily allocated histogram, most operations are never used */
+class OperationStats final
+{
+public:
+    OperationStats() : histogram_()
+    {
+    }
+
+    LatencyHistogram &histogram()
+    {
+        if (!histogram_) {
+            histogram_.reset(new LatencyHistogram());
+        }
+        return *histogram_;
+    }
+
+    /** null if nothing was recorded */
+    const LatencyHistogram *recorded() const
+    {
+        return histogram_.get();
+    }
+
+private:
+    std::unique_ptr<LatencyHistogram> histogram_;
+};
+
+/** record the lifetime of the timer, does nothing without a histogram */
+class ScopedTimer final
+{
+public:
+    explicit ScopedTimer(LatencyHistogram *h)
+            : histogram_(h),
+              start_(h ? std::chrono::steady_clock::now() :
+                         std::chrono::steady_clock::time_point())
+    {
+    }
+
+    ScopedTimer(ScopedTimer &&t) : histogram_(t.histogram_), start_(t.start_)
+    {
+        t.histogram_ = nullptr;
+    }
+
+    ~ScopedTimer()
+    {
+        if (histogram_) {
+            histogram_->record((uint64_t)
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start_).count());
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer &operator=(const ScopedTimer&) = delete;
+
+private:
+    LatencyHistogram *histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} /* namespace metrics */
+
+#endif /* METRICS_H_ */
@@ -0,0 +1,419 @@
+/*
+ * NTriplesReader.cpp - read N-Triples and N-Quads files without raptor
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+
+#include "NTriplesReader.h"
+#include "Decompressor.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rdf
+{
+
+/** size of the arena blocks, larger terms get a block of their own */
+static const size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+static inline const char *skip_space(const char *p, const char *end)
+{
+    while (p != end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    return p;
+}
+
+static inline int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/** append the UTF-8 encoding of a code point, return the new end */
+static char *encode_utf8(char *out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        *out++ = (char) cp;
+    } else if (cp < 0x800) {
+        *out++ = (char) (0xC0 | (cp >> 6));
+        *out++ = (char) (0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = (char) (0xE0 | (cp >> 12));
+        *out++ = (char) (0x80 | ((cp >> 6) & 0x3F));
+        *out++ = (char) (0x80 | (cp & 0x3F));
+    } else {
+        *out++ = (char) (0xF0 | (cp >> 18));
+        *out++ = (char) (0x80 | ((cp >> 12) & 0x3F));
+        *out++ = (char) (0x80 | ((cp >> 6) & 0x3F));
+        *out++ = (char) (0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+NTriplesReader::NTriplesReader(const char *fileName,
+                               const std::string &blankPrefix) :
+        data_(nullptr),
+        end_(nullptr),
+        pos_(nullptr),
+        mappedSize_(0),
+        buffer_(),
+        source_(),
+        chunk_(),
+        line_(0),
+        blankPrefix_(blankPrefix),
+        blocks_(),
+        block_(0),
+        used_(0)
+{
+    const Compression compression = file_compression(fileName);
+    if (compression != COMPRESSION_NONE) {
+        source_.reset(new Decompressor(fileName, compression));
+        data_ = end_ = pos_ = buffer_.data();
+        fill();
+        skipByteOrderMark();
+        return;
+    }
+
+    const int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Failed to open ") + fileName +
+                                 ": " + strerror(errno));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *m = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+                       fd, 0);
+        if (m != MAP_FAILED) {
+            madvise(m, (size_t) st.st_size, MADV_SEQUENTIAL);
+            data_ = (const char*) m;
+            mappedSize_ = (size_t) st.st_size;
+        }
+    }
+
+    if (!mappedSize_) {
+        // pipes and file systems which can't be mapped
+        char chunk[64 * 1024];
+        ssize_t n;
+        while ((n = ::read(fd, chunk, sizeof(chunk))) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                const int err = errno;
+                close(fd);
+                throw std::runtime_error(std::string("Failed to read ") +
+                                         fileName + ": " + strerror(err));
+            }
+            buffer_.append(chunk, (size_t) n);
+        }
+        data_ = buffer_.data();
+    }
+    close(fd);
+
+    end_ = data_ + (mappedSize_ ? mappedSize_ : buffer_.size());
+    pos_ = data_;
+    skipByteOrderMark();
+}
+
+NTriplesReader::~NTriplesReader()
+{
+    if (mappedSize_) {
+        munmap((void*) data_, mappedSize_);
+    }
+}
+
+void NTriplesReader::skipByteOrderMark()
+{
+    if (end_ - pos_ >= 3 && memcmp(pos_, "\xEF\xBB\xBF", 3) == 0) {
+        pos_ += 3;
+    }
+}
+
+/**
+ * Append the next decompressed chunk to the unread data, return false at
+ * the end of the input.
+ */
+bool NTriplesReader::fill()
+{
+    if (!source_ || !source_->next(chunk_)) {
+        return false;
+    }
+    buffer_.erase(0, pos_ - buffer_.data());
+    buffer_.append(chunk_);
+    data_ = pos_ = buffer_.data();
+    end_ = data_ + buffer_.size();
+    return true;
+}
+
+bool NTriplesReader::read(std::vector<NodeQuad> &quads, size_t maxCount)
+{
+    quads.clear();
+    block_ = 0;
+    used_ = 0;
+    while (quads.size() < maxCount) {
+        const char *eol = (const char*) memchr(pos_, '\n', end_ - pos_);
+        if (!eol && fill()) {
+            // the line continues in the next chunk
+            continue;
+        }
+        if (pos_ == end_) {
+            break;
+        }
+        const char *lineEnd = eol ? eol : end_;
+        ++line_;
+        if (lineEnd != pos_ && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        parseLine(pos_, lineEnd, quads);
+        pos_ = eol ? eol + 1 : end_;
+    }
+    return !quads.empty();
+}
+
+void NTriplesReader::parseLine(const char *p, const char *end,
+                               std::vector<NodeQuad> &quads)
+{
+    p = skip_space(p, end);
+    if (p == end || *p == '#') {
+        return;
+    }
+
+    NodeQuad q;
+    q.graph = nullptr;
+    p = skip_space(parseTerm(p, end, q.subject), end);
+    if (q.subject.kind == NODE_KIND_LITERAL) {
+        fail("literal subject");
+    }
+    p = skip_space(parseTerm(p, end, q.predicate), end);
+    if (q.predicate.kind != NODE_KIND_RESOURCE) {
+        fail("the predicate is not an IRI");
+    }
+    p = skip_space(parseTerm(p, end, q.object), end);
+    if (p != end && *p != '.') {
+        NodeTerm graph;
+        p = skip_space(parseTerm(p, end, graph), end);
+        if (graph.kind != NODE_KIND_RESOURCE) {
+            // CONTEXT only holds URIs
+            fail("the graph name is not an IRI (blank node graph names "
+                 "are not supported)");
+        }
+        q.graph = graph.value;
+    }
+    if (p == end || *p != '.') {
+        fail("expected '.'");
+    }
+    p = skip_space(p + 1, end);
+    if (p != end && *p != '#') {
+        fail("unexpected text after '.'");
+    }
+    quads.push_back(q);
+}
+
+const char *NTriplesReader::parseTerm(const char *p, const char *end,
+                                      NodeTerm &term)
+{
+    term.lang = nullptr;
+    term.datatype = nullptr;
+    if (p == end) {
+        fail("unexpected end of line");
+    }
+
+    if (*p == '<') {
+        term.kind = NODE_KIND_RESOURCE;
+        return parseIri(p, end, term.value);
+    }
+
+    if (*p == '_') {
+        if (end - p < 3 || p[1] != ':') {
+            fail("bad blank node label");
+        }
+        const char *label = p + 2;
+        const char *q = label;
+        while (q != end && *q != ' ' && *q != '\t' && *q != '<' &&
+               *q != '#') {
+            ++q;
+        }
+        // a label can't end with '.', that is the end of the statement
+        while (q != label && q[-1] == '.') {
+            --q;
+        }
+        if (q == label) {
+            fail("empty blank node label");
+        }
+        const size_t prefixLength = blankPrefix_.size();
+        char *value = allocate(prefixLength + (q - label) + 1);
+        memcpy(value, blankPrefix_.data(), prefixLength);
+        memcpy(value + prefixLength, label, q - label);
+        value[prefixLength + (q - label)] = '\0';
+        term.kind = NODE_KIND_BLANK;
+        term.value = value;
+        return q;
+    }
+
+    if (*p == '"') {
+        // the closing quote is the first one not preceded by an odd number
+        // of backslashes
+        const char *q = p + 1;
+        for (;;) {
+            q = (const char*) memchr(q, '"', end - q);
+            if (!q) {
+                fail("unterminated literal");
+            }
+            const char *b = q;
+            while (b[-1] == '\\') {
+                --b;
+            }
+            if ((q - b) % 2 == 0) {
+                break;
+            }
+            ++q;
+        }
+        term.kind = NODE_KIND_LITERAL;
+        term.value = copy(p + 1, q, true);
+        p = q + 1;
+        if (p != end && *p == '@') {
+            const char *tag = ++p;
+            while (p != end && ((*p >= 'a' && *p <= 'z') ||
+                                (*p >= 'A' && *p <= 'Z') ||
+                                (*p >= '0' && *p <= '9') || *p == '-')) {
+                ++p;
+            }
+            if (p == tag) {
+                fail("empty language tag");
+            }
+            char *lang = allocate(p - tag + 1);
+            memcpy(lang, tag, p - tag);
+            lang[p - tag] = '\0';
+            term.lang = lang;
+        } else if (end - p >= 2 && p[0] == '^' && p[1] == '^') {
+            p += 2;
+            if (p == end || *p != '<') {
+                fail("expected a datatype IRI");
+            }
+            p = parseIri(p, end, term.datatype);
+        }
+        return p;
+    }
+
+    fail("expected an IRI, a blank node or a literal");
+}
+
+const char *NTriplesReader::parseIri(const char *p, const char *end,
+                                     const char *&iri)
+{
+    const char *q = (const char*) memchr(p + 1, '>', end - p - 1);
+    if (!q) {
+        fail("unterminated IRI");
+    }
+    iri = copy(p + 1, q, false);
+    return q + 1;
+}
+
+/**
+ * Copy [p, end) to the arena with a terminating NUL, resolving \u and \U
+ * escapes and, in literals, the single character ones. The result is never
+ * longer than the escaped text.
+ */
+const char *NTriplesReader::copy(const char *p, const char *end, bool literal)
+{
+    char *out = allocate(end - p + 1);
+    char *o = out;
+    for (;;) {
+        const char *bs = (const char*) memchr(p, '\\', end - p);
+        const char *stop = bs ? bs : end;
+        memcpy(o, p, stop - p);
+        o += stop - p;
+        if (!bs) {
+            break;
+        }
+        p = bs + 1;
+        if (p == end) {
+            fail("bad escape sequence");
+        }
+        const char e = *p++;
+        int digits = 0;
+        switch (e) {
+        case 'u':
+            digits = 4;
+            break;
+        case 'U':
+            digits = 8;
+            break;
+        case 't': case 'b': case 'n': case 'r': case 'f':
+        case '"': case '\'': case '\\':
+            if (!literal) {
+                fail("bad escape sequence in IRI");
+            }
+            *o++ = e == 't' ? '\t' : e == 'b' ? '\b' : e == 'n' ? '\n' :
+                   e == 'r' ? '\r' : e == 'f' ? '\f' : e;
+            continue;
+        default:
+            fail("bad escape sequence");
+        }
+        if (end - p < digits) {
+            fail("bad escape sequence");
+        }
+        uint32_t cp = 0;
+        for (int i = 0; i != digits; ++i) {
+            const int v = hex_value(*p++);
+            if (v < 0) {
+                fail("bad escape sequence");
+            }
+            cp = (cp << 4) | (uint32_t) v;
+        }
+        if (cp > 0x10FFFF) {
+            fail("escaped code point out of range");
+        }
+        o = encode_utf8(o, cp);
+    }
+    *o = '\0';
+    return out;
+}
+
+char *NTriplesReader::allocate(size_t size)
+{
+    while (block_ != blocks_.size() &&
+           blocks_[block_].size() - used_ < size) {
+        ++block_;
+        used_ = 0;
+    }
+    if (block_ == blocks_.size()) {
+        blocks_.emplace_back(std::max(size, ARENA_BLOCK_SIZE));
+        used_ = 0;
+    }
+    char *p = blocks_[block_].data() + used_;
+    used_ += size;
+    return p;
+}
+
+void NTriplesReader::fail(const char *message) const
+{
+    throw std::runtime_error("line " + std::to_string(line_) + ": " +
+                             message);
+}
+
+} /* namespace rdf */
@@ -0,0 +1,123 @@
+/*
+ * NTriplesReader.h - read N-Triples and N-Quads files without raptor
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#ifndef NTRIPLESREADER_H_
+#define NTRIPLESREADER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RdfDbSchemaBuilder.h"
+
+
+namespace rdf
+{
+
+class Decompressor;
+
+/**
+ * A node as NUL terminated strings: a URI, a blank node name or a literal
+ * value with an optional language or datatype URI.
+ */
+struct NodeTerm
+{
+    NodeKind kind;
+    const char *value;
+    const char *lang;
+    const char *datatype;
+};
+
+/** a statement read by NTriplesReader */
+struct NodeQuad
+{
+    NodeTerm subject;
+    NodeTerm predicate;
+    NodeTerm object;
+    /**
+     * the graph IRI of an N-Quads statement, nullptr in the default graph;
+     * blank node graph names are rejected, contexts are URIs in this storage
+     */
+    const char *graph;
+};
+
+/**
+ * Streaming reader of N-Triples and N-Quads (a graph IRI before the final
+ * '.' is accepted on any line). The file is memory mapped and scanned with
+ * memchr, the terms are unescaped into an arena which is reused for each
+ * batch of statements, so that no node objects are built. Files ending
+ * with .gz or .zst are read from a Decompressor instead. Blank node labels
+ * are only meaningful within one file, the reader puts a prefix in front
+ * of them so that the nodes of different files stay apart.
+ */
+class NTriplesReader final
+{
+public:
+    /**
+     * Prepend blankPrefix to the blank node labels of the file. Throw
+     * std::runtime_error if the file can't be opened or its compression
+     * isn't supported.
+     */
+    NTriplesReader(const char *fileName, const std::string &blankPrefix);
+    ~NTriplesReader();
+
+    NTriplesReader(const NTriplesReader&) = delete;
+    NTriplesReader &operator=(const NTriplesReader&) = delete;
+
+    /**
+     * Replace the content of quads with up to maxCount statements, return
+     * false if there were none left. The strings of the statements are
+     * valid until the next call. Throw std::runtime_error with the line
+     * number on syntax errors.
+     */
+    bool read(std::vector<NodeQuad> &quads, size_t maxCount);
+
+    /** the number of the line last read, 1 based */
+    size_t line() const
+    {
+        return line_;
+    }
+
+private:
+    void parseLine(const char *p, const char *end,
+                   std::vector<NodeQuad> &quads);
+    const char *parseTerm(const char *p, const char *end, NodeTerm &term);
+    const char *parseIri(const char *p, const char *end, const char *&iri);
+    const char *copy(const char *p, const char *end, bool literal);
+    char *allocate(size_t size);
+    bool fill();
+    void skipByteOrderMark();
+    [[noreturn]] void fail(const char *message) const;
+
+    const char *data_;
+    const char *end_;
+    const char *pos_;
+    size_t mappedSize_;
+    // the file content if it couldn't be mapped, or the part of the
+    // decompressed data not read yet
+    std::string buffer_;
+    std::unique_ptr<Decompressor> source_;
+    std::string chunk_;
+    size_t line_;
+    const std::string blankPrefix_;
+
+    // blocks of the arena the terms are copied to
+    std::vector<std::vector<char>> blocks_;
+    size_t block_;
+    size_t used_;
+};
+
+} /* namespace rdf */
+
+#endif /* NTRIPLESREADER_H_ */
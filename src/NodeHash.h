@@ -0,0 +1,46 @@
+/*
+ * NodeHash.h - fixed width hash of node strings for indexed lookups
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#ifndef NODEHASH_H_
+#define NODEHASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace rdf
+{
+
+/**
+ * 64 bit FNV-1a hash of a URI or literal value, stored in the URI_HASH and
+ * VAL_HASH columns. The hash only narrows down index lookups, the strings
+ * themselves are always compared too.
+ */
+inline int64_t node_hash(const char *str, size_t len)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i != len; ++i) {
+        h ^= (unsigned char) str[i];
+        h *= 1099511628211ULL;
+    }
+    return (int64_t) h;
+}
+
+inline int64_t node_hash(const char *str)
+{
+    return node_hash(str, strlen(str));
+}
+
+} /* namespace rdf */
+
+#endif /* NODEHASH_H_ */
@@ -13,10 +13,181 @@
  */
 
 #include "PreparedStatements.h"
+#include "RdfDbSchemaBuilder.h"
 
 namespace rdf {
 namespace impl {
 
+const char * const PREP_STATEMENT_NAMES[LAST_PREP_STATEMENT_IDX] = {
+    "GET_RESOURCE_ID",
+    "INSERT_RESOURCE",
+    "GET_CONTEXT_ID",
+    "INSERT_CONTEXT",
+    "GET_BNODE_ID",
+    "INSERT_BNODE",
+    "GET_LITERAL_ID_1",
+    "GET_LITERAL_ID_2_LANG",
+    "GET_LITERAL_ID_3_DT",
+    "INSERT_LITERAL",
+    "SELECT_TRIPLE_0",
+    "SELECT_TRIPLE_1",
+    "SELECT_TRIPLE_2",
+    "SELECT_TRIPLE_3",
+    "SELECT_TRIPLE_4",
+    "SELECT_TRIPLE_5",
+    "SELECT_TRIPLE_6",
+    "SELECT_TRIPLE_7",
+    "SELECT_TRIPLE_8",
+    "SELECT_TRIPLE_9",
+    "SELECT_TRIPLE_10",
+    "SELECT_TRIPLE_11",
+    "SELECT_TRIPLE_SPOC_0",
+    "SELECT_TRIPLE_SPOC_1",
+    "SELECT_TRIPLE_SPOC_2",
+    "SELECT_TRIPLE_SPOC_3",
+    "SELECT_TRIPLE_SPOC_4",
+    "SELECT_TRIPLE_SPOC_5",
+    "SELECT_TRIPLE_SPOC_6",
+    "SELECT_TRIPLE_SPOC_7",
+    "SELECT_TRIPLE_SPOC_8",
+    "SELECT_TRIPLE_SPOC_9",
+    "SELECT_TRIPLE_SPOC_10",
+    "SELECT_TRIPLE_SPOC_11",
+    "INSERT_TRIPLE",
+    "GET_TRIPLE_COUNT",
+    "DELETE_TRIPLE",
+    "GET_CONTEXTS",
+    "INSERT_RESOURCE_UNIFIED",
+    "INSERT_BNODE_UNIFIED",
+    "INSERT_LITERAL_UNIFIED",
+    "SELECT_TRIPLE_UNIFIED_0",
+    "SELECT_TRIPLE_UNIFIED_1",
+    "INSERT_TRIPLE_UNIFIED",
+    "GET_RESOURCE_ID_HASH",
+    "INSERT_RESOURCE_HASH",
+    "INSERT_RESOURCE_UNIFIED_HASH",
+    "GET_LITERAL_ID_1_HASH",
+    "GET_LITERAL_ID_2_LANG_HASH",
+    "GET_LITERAL_ID_3_DT_HASH",
+    "INSERT_LITERAL_HASH",
+    "INSERT_LITERAL_UNIFIED_HASH",
+    "GET_LONG_LITERAL_ID_1",
+    "GET_LONG_LITERAL_ID_2_LANG",
+    "GET_LONG_LITERAL_ID_3_DT",
+    "INSERT_LONG_LITERAL",
+    "INSERT_LONG_LITERAL_UNIFIED",
+    "GET_LONG_LITERAL_VAL",
+    "GET_TRIPLE_COUNT_MAINTAINED",
+    "GET_CONTEXT_TRIPLE_COUNT",
+    "GET_CONTEXT_TRIPLE_COUNT_MAINTAINED",
+    "GET_CONTEXTS_MAINTAINED",
+    "GET_TRIPLE_COUNT_ROWS",
+    "DELETE_CONTEXT_TRIPLES",
+    "DELETE_DEFAULT_CONTEXT_TRIPLES",
+    "DELETE_ORPHAN_CONTEXTS",
+    "DELETE_TRIPLE_BATCH",
+    "GET_NODE_GC_POSITION",
+    "SET_NODE_GC_POSITION",
+    "SCAN_TRIPLE_KEYS",
+    "SCAN_TRIPLE_KEYS_UNIFIED",
+    "GET_TRIPLE_SEQUENCE",
+    "GET_RESOURCE_IDS",
+    "GET_RESOURCE_IDS_HASH",
+    "GET_BNODE_IDS",
+    "GET_LITERAL_IDS",
+    "GET_LITERAL_IDS_HASH",
+    "DELETE_ORPHAN_CONTEXTS_LOGGED",
+    "GET_TRIPLE_LOG_CHANGES",
+    "GET_TRIPLE_LOG_WATERMARK",
+    "TRIM_TRIPLE_LOG",
+    "GET_DATABASE_ID",
+};
+
+bool prep_statement_applies(PrepStatementIndex psi, unsigned int schemaFlags)
+{
+    // the objects a statement needs and those which replace the ones it
+    // refers to, like the onlyIf and unless of the schema objects
+    unsigned int onlyIf = SCHEMA_DEFAULT;
+    unsigned int unless = SCHEMA_DEFAULT;
+    switch (psi) {
+    case INSERT_RESOURCE:
+    case INSERT_BNODE:
+    case INSERT_LITERAL:
+    case INSERT_TRIPLE:
+    case SCAN_TRIPLE_KEYS:
+        unless = SCHEMA_UNIFIED_NODES;
+        break;
+    case SELECT_TRIPLE_0: case SELECT_TRIPLE_1: case SELECT_TRIPLE_2:
+    case SELECT_TRIPLE_3: case SELECT_TRIPLE_4: case SELECT_TRIPLE_5:
+    case SELECT_TRIPLE_6: case SELECT_TRIPLE_7: case SELECT_TRIPLE_8:
+    case SELECT_TRIPLE_9: case SELECT_TRIPLE_10: case SELECT_TRIPLE_11:
+        unless = SCHEMA_COMPOSITE_INDEXES | SCHEMA_UNIFIED_NODES;
+        break;
+    case SELECT_TRIPLE_SPOC_0: case SELECT_TRIPLE_SPOC_1:
+    case SELECT_TRIPLE_SPOC_2: case SELECT_TRIPLE_SPOC_3:
+    case SELECT_TRIPLE_SPOC_4: case SELECT_TRIPLE_SPOC_5:
+    case SELECT_TRIPLE_SPOC_6: case SELECT_TRIPLE_SPOC_7:
+    case SELECT_TRIPLE_SPOC_8: case SELECT_TRIPLE_SPOC_9:
+    case SELECT_TRIPLE_SPOC_10: case SELECT_TRIPLE_SPOC_11:
+        onlyIf = SCHEMA_COMPOSITE_INDEXES;
+        unless = SCHEMA_UNIFIED_NODES;
+        break;
+    case INSERT_RESOURCE_UNIFIED:
+    case INSERT_BNODE_UNIFIED:
+    case INSERT_LITERAL_UNIFIED:
+    case SELECT_TRIPLE_UNIFIED_0:
+    case SELECT_TRIPLE_UNIFIED_1:
+    case INSERT_TRIPLE_UNIFIED:
+    case SCAN_TRIPLE_KEYS_UNIFIED:
+        onlyIf = SCHEMA_UNIFIED_NODES;
+        break;
+    case GET_RESOURCE_ID_HASH:
+    case GET_LITERAL_ID_1_HASH:
+    case GET_LITERAL_ID_2_LANG_HASH:
+    case GET_LITERAL_ID_3_DT_HASH:
+    case GET_RESOURCE_IDS_HASH:
+    case GET_LITERAL_IDS_HASH:
+        onlyIf = SCHEMA_HASH_LOOKUP;
+        break;
+    case INSERT_RESOURCE_HASH:
+    case INSERT_LITERAL_HASH:
+        onlyIf = SCHEMA_HASH_LOOKUP;
+        unless = SCHEMA_UNIFIED_NODES;
+        break;
+    case INSERT_RESOURCE_UNIFIED_HASH:
+    case INSERT_LITERAL_UNIFIED_HASH:
+        onlyIf = SCHEMA_HASH_LOOKUP | SCHEMA_UNIFIED_NODES;
+        break;
+    case GET_LONG_LITERAL_ID_1:
+    case GET_LONG_LITERAL_ID_2_LANG:
+    case GET_LONG_LITERAL_ID_3_DT:
+    case GET_LONG_LITERAL_VAL:
+        onlyIf = SCHEMA_LONG_LITERALS;
+        break;
+    case INSERT_LONG_LITERAL:
+        onlyIf = SCHEMA_LONG_LITERALS;
+        unless = SCHEMA_UNIFIED_NODES;
+        break;
+    case INSERT_LONG_LITERAL_UNIFIED:
+        onlyIf = SCHEMA_LONG_LITERALS | SCHEMA_UNIFIED_NODES;
+        break;
+    case GET_TRIPLE_COUNT_MAINTAINED:
+    case GET_CONTEXT_TRIPLE_COUNT_MAINTAINED:
+    case GET_CONTEXTS_MAINTAINED:
+    case GET_TRIPLE_COUNT_ROWS:
+        onlyIf = SCHEMA_TRIPLE_COUNT;
+        break;
+    case DELETE_ORPHAN_CONTEXTS_LOGGED:
+    case GET_TRIPLE_LOG_CHANGES:
+    case GET_TRIPLE_LOG_WATERMARK:
+    case TRIM_TRIPLE_LOG:
+        onlyIf = SCHEMA_TRIPLE_LOG;
+        break;
+    default:
+        break;
+    }
+    return (onlyIf & schemaFlags) == onlyIf && (unless & schemaFlags) == 0;
+}
 
 PreparedStatements::PreparedStatements() : statements_{
         {
@@ -172,6 +343,114 @@ PreparedStatements::PreparedStatements() : statements_{
             nullptr,
             3, 1
         },
+        {
+            // SELECT_TRIPLE_SPOC_0
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI=? AND r.S_BLANK IS NULL"
+            " AND r.P_URI=? AND r.O_URI=? AND r.O_BLANK IS NULL AND r.O_LITERAL IS NULL"
+            " AND r.C_URI=?"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            4, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_1
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI=? AND r.S_BLANK IS NULL"
+            " AND r.P_URI=? AND r.O_URI=? AND r.O_BLANK IS NULL AND r.O_LITERAL IS NULL"
+            " AND r.C_URI IS NULL"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            3, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_2
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI=? AND r.S_BLANK IS NULL"
+            " AND r.P_URI=? AND r.O_URI IS NULL AND r.O_BLANK=? AND r.O_LITERAL IS NULL"
+            " AND r.C_URI=?"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            4, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_3
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI=? AND r.S_BLANK IS NULL"
+            " AND r.P_URI=? AND r.O_URI IS NULL AND r.O_BLANK=? AND r.O_LITERAL IS NULL"
+            " AND r.C_URI IS NULL"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            3, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_4
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI=? AND r.S_BLANK IS NULL"
+            " AND r.P_URI=? AND r.O_URI IS NULL AND r.O_BLANK IS NULL AND r.O_LITERAL=?"
+            " AND r.C_URI=?"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            4, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_5
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI=? AND r.S_BLANK IS NULL"
+            " AND r.P_URI=? AND r.O_URI IS NULL AND r.O_BLANK IS NULL AND r.O_LITERAL=?"
+            " AND r.C_URI IS NULL"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            3, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_6
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI IS NULL AND r.S_BLANK=?"
+            " AND r.P_URI=? AND r.O_URI=? AND r.O_BLANK IS NULL AND r.O_LITERAL IS NULL"
+            " AND r.C_URI=?"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            4, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_7
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI IS NULL AND r.S_BLANK=?"
+            " AND r.P_URI=? AND r.O_URI=? AND r.O_BLANK IS NULL AND r.O_LITERAL IS NULL"
+            " AND r.C_URI IS NULL"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            3, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_8
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI IS NULL AND r.S_BLANK=?"
+            " AND r.P_URI=? AND r.O_URI IS NULL AND r.O_BLANK=? AND r.O_LITERAL IS NULL"
+            " AND r.C_URI=?"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            4, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_9
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI IS NULL AND r.S_BLANK=?"
+            " AND r.P_URI=? AND r.O_URI IS NULL AND r.O_BLANK=? AND r.O_LITERAL IS NULL"
+            " AND r.C_URI IS NULL"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            3, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_10
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI IS NULL AND r.S_BLANK=?"
+            " AND r.P_URI=? AND r.O_URI IS NULL AND r.O_BLANK IS NULL AND r.O_LITERAL=?"
+            " AND r.C_URI=?"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            4, 1
+        },
+        {
+            // SELECT_TRIPLE_SPOC_11
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_URI IS NULL AND r.S_BLANK=?"
+            " AND r.P_URI=? AND r.O_URI IS NULL AND r.O_BLANK IS NULL AND r.O_LITERAL=?"
+            " AND r.C_URI IS NULL"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            3, 1
+        },
         {
             // INSERT_TRIPLE
             "INSERT INTO TRIPLE (ID, S_URI, S_BLANK, P_URI, O_URI, O_BLANK, "
@@ -195,8 +474,388 @@ PreparedStatements::PreparedStatements() : statements_{
         },
         {
             // GET_CONTEXTS
-            "SELECT URI "
-            "FROM CONTEXT",
+            "SELECT c.URI "
+            "FROM CONTEXT c "
+            "WHERE EXISTS (SELECT 1 FROM TRIPLE r WHERE r.C_URI = c.ID)",
+            nullptr,
+            0, 1
+        },
+        {
+            // INSERT_RESOURCE_UNIFIED
+            "INSERT INTO RESOURCE (ID, URI) "
+            "VALUES (NEXT VALUE FOR SEQ_NODE, ?) "
+            "RETURNING ID",
+            nullptr,
+            2, 1
+        },
+        {
+            // INSERT_BNODE_UNIFIED
+            "INSERT INTO BNODE (ID, NAME) "
+            "VALUES (NEXT VALUE FOR SEQ_NODE, ?) "
+            "RETURNING ID",
+            nullptr,
+            2, 1
+        },
+        {
+            // INSERT_LITERAL_UNIFIED
+            "INSERT INTO LITERAL (ID, VAL, LANGUAGE, DATATYPE) "
+            "VALUES (NEXT VALUE FOR SEQ_NODE, ?, ?, ?) "
+            "RETURNING ID",
+            nullptr,
+            3, 1
+        },
+        {
+            // SELECT_TRIPLE_UNIFIED_0
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_ID=? AND r.P_URI=? AND r.O_ID=? AND r.C_URI=?"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            4, 1
+        },
+        {
+            // SELECT_TRIPLE_UNIFIED_1
+            "SELECT r.ID FROM TRIPLE r WHERE r.S_ID=? AND r.P_URI=? AND r.O_ID=? AND r.C_URI IS NULL"
+            " PLAN (r INDEX (IDX_TRIPLE_SPOC))",
+            nullptr,
+            3, 1
+        },
+        {
+            // INSERT_TRIPLE_UNIFIED
+            "INSERT INTO TRIPLE (ID, S_ID, S_KIND, P_URI, O_ID, O_KIND, C_URI) "
+            "VALUES (NEXT VALUE FOR SEQ_TRIPLE, ?, ?, ?, ?, ?, ?) "
+            "RETURNING ID",
+            nullptr,
+            6, 1
+        },
+        {
+            // GET_RESOURCE_ID_HASH
+            "SELECT ID FROM RESOURCE WHERE URI_HASH=? AND URI=?"
+            " PLAN (RESOURCE INDEX (IDX_RESOURCE_URI_HASH))",
+            nullptr,
+            2, 1
+        },
+        {
+            // INSERT_RESOURCE_HASH
+            "INSERT INTO RESOURCE (ID, URI, URI_HASH) "
+            "VALUES (NEXT VALUE FOR SEQ_RESOURCE, ?, ?) "
+            "RETURNING ID",
+            nullptr,
+            2, 1
+        },
+        {
+            // INSERT_RESOURCE_UNIFIED_HASH
+            "INSERT INTO RESOURCE (ID, URI, URI_HASH) "
+            "VALUES (NEXT VALUE FOR SEQ_NODE, ?, ?) "
+            "RETURNING ID",
+            nullptr,
+            2, 1
+        },
+        {
+            // GET_LITERAL_ID_1_HASH
+            "SELECT ID FROM LITERAL WHERE VAL_HASH=? AND VAL=? "
+            "AND LANGUAGE IS NULL AND DATATYPE IS NULL"
+            " PLAN (LITERAL INDEX (IDX_LITERAL_VAL_HASH))",
+            nullptr,
+            2, 1
+        },
+        {
+            // GET_LITERAL_ID_2_LANG_HASH
+            "SELECT ID FROM LITERAL WHERE VAL_HASH=? AND VAL=? "
+            "AND LANGUAGE=? AND DATATYPE IS NULL"
+            " PLAN (LITERAL INDEX (IDX_LITERAL_VAL_HASH))",
+            nullptr,
+            3, 1
+        },
+        {
+            // GET_LITERAL_ID_3_DT_HASH
+            "SELECT ID FROM LITERAL WHERE VAL_HASH=? AND VAL=? "
+            "AND LANGUAGE IS NULL AND DATATYPE=?"
+            " PLAN (LITERAL INDEX (IDX_LITERAL_VAL_HASH))",
+            nullptr,
+            3, 1
+        },
+        {
+            // INSERT_LITERAL_HASH
+            "INSERT INTO LITERAL (ID, VAL, LANGUAGE, DATATYPE, VAL_HASH) "
+            "VALUES (NEXT VALUE FOR SEQ_LITERAL, ?, ?, ?, ?) "
+            "RETURNING ID",
+            nullptr,
+            4, 1
+        },
+        {
+            // INSERT_LITERAL_UNIFIED_HASH
+            "INSERT INTO LITERAL (ID, VAL, LANGUAGE, DATATYPE, VAL_HASH) "
+            "VALUES (NEXT VALUE FOR SEQ_NODE, ?, ?, ?, ?) "
+            "RETURNING ID",
+            nullptr,
+            4, 1
+        },
+        {
+            // GET_LONG_LITERAL_ID_1
+            "SELECT ID FROM LITERAL WHERE VAL_HASH=? AND VAL IS NULL "
+            "AND VAL_BLOB=CAST(? AS VARCHAR(32765)) "
+            "AND LANGUAGE IS NULL AND DATATYPE IS NULL"
+            " PLAN (LITERAL INDEX (IDX_LITERAL_VAL_HASH))",
+            nullptr,
+            2, 1
+        },
+        {
+            // GET_LONG_LITERAL_ID_2_LANG
+            "SELECT ID FROM LITERAL WHERE VAL_HASH=? AND VAL IS NULL "
+            "AND VAL_BLOB=CAST(? AS VARCHAR(32765)) "
+            "AND LANGUAGE=? AND DATATYPE IS NULL"
+            " PLAN (LITERAL INDEX (IDX_LITERAL_VAL_HASH))",
+            nullptr,
+            3, 1
+        },
+        {
+            // GET_LONG_LITERAL_ID_3_DT
+            "SELECT ID FROM LITERAL WHERE VAL_HASH=? AND VAL IS NULL "
+            "AND VAL_BLOB=CAST(? AS VARCHAR(32765)) "
+            "AND LANGUAGE IS NULL AND DATATYPE=?"
+            " PLAN (LITERAL INDEX (IDX_LITERAL_VAL_HASH))",
+            nullptr,
+            3, 1
+        },
+        {
+            // INSERT_LONG_LITERAL
+            "INSERT INTO LITERAL (ID, VAL_BLOB, LANGUAGE, DATATYPE, VAL_HASH) "
+            "VALUES (NEXT VALUE FOR SEQ_LITERAL, CAST(? AS VARCHAR(32765)), "
+            "?, ?, ?) "
+            "RETURNING ID",
+            nullptr,
+            4, 1
+        },
+        {
+            // INSERT_LONG_LITERAL_UNIFIED
+            "INSERT INTO LITERAL (ID, VAL_BLOB, LANGUAGE, DATATYPE, VAL_HASH) "
+            "VALUES (NEXT VALUE FOR SEQ_NODE, CAST(? AS VARCHAR(32765)), "
+            "?, ?, ?) "
+            "RETURNING ID",
+            nullptr,
+            4, 1
+        },
+        {
+            // GET_LONG_LITERAL_VAL
+            "SELECT CAST(VAL_BLOB AS VARCHAR(32765)) FROM LITERAL WHERE ID=?",
+            nullptr,
+            1, 1
+        },
+        {
+            // GET_TRIPLE_COUNT_MAINTAINED
+            "SELECT COALESCE(SUM(DELTA), 0) FROM TRIPLE_COUNT",
+            nullptr,
+            0, 1
+        },
+        {
+            // GET_CONTEXT_TRIPLE_COUNT
+            "SELECT COUNT(*) FROM TRIPLE WHERE C_URI=?",
+            nullptr,
+            1, 1
+        },
+        {
+            // GET_CONTEXT_TRIPLE_COUNT_MAINTAINED
+            "SELECT COALESCE(SUM(DELTA), 0) FROM TRIPLE_COUNT WHERE C_URI=?",
+            nullptr,
+            1, 1
+        },
+        {
+            // GET_CONTEXTS_MAINTAINED
+            "SELECT c.URI "
+            "FROM CONTEXT_STATS s "
+            "JOIN CONTEXT c ON s.C_URI = c.ID "
+            "WHERE s.TRIPLE_COUNT > 0",
+            nullptr,
+            0, 1
+        },
+        {
+            // GET_TRIPLE_COUNT_ROWS, stops counting at the given limit
+            "SELECT COUNT(*) FROM (SELECT FIRST (?) 1 FROM TRIPLE_COUNT)",
+            nullptr,
+            1, 1
+        },
+        {
+            // DELETE_CONTEXT_TRIPLES
+            "EXECUTE BLOCK (C BIGINT = ?, N INTEGER = ?) "
+            "RETURNS (DELETED INTEGER) AS "
+            "BEGIN "
+            "DELETE FROM TRIPLE WHERE C_URI = :C ROWS :N; "
+            "DELETED = ROW_COUNT; "
+            "SUSPEND; "
+            "END",
+            nullptr,
+            2, 1
+        },
+        {
+            // DELETE_DEFAULT_CONTEXT_TRIPLES
+            "EXECUTE BLOCK (N INTEGER = ?) "
+            "RETURNS (DELETED INTEGER) AS "
+            "BEGIN "
+            "DELETE FROM TRIPLE WHERE C_URI IS NULL ROWS :N; "
+            "DELETED = ROW_COUNT; "
+            "SUSPEND; "
+            "END",
+            nullptr,
+            1, 1
+        },
+        {
+            // DELETE_ORPHAN_CONTEXTS
+            "DELETE FROM CONTEXT c "
+            "WHERE NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.C_URI = c.ID)",
+            nullptr,
+            0, 0
+        },
+        {
+            // DELETE_TRIPLE_BATCH
+            "DELETE FROM TRIPLE WHERE ID IN ("
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?)",
+            nullptr,
+            128, 0
+        },
+        {
+            // GET_NODE_GC_POSITION
+            "SELECT LAST_ID FROM NODE_GC_STATE WHERE TABLE_NAME=?",
+            nullptr,
+            1, 1
+        },
+        {
+            // SET_NODE_GC_POSITION
+            "UPDATE OR INSERT INTO NODE_GC_STATE (TABLE_NAME, LAST_ID) "
+            "VALUES (?, ?) MATCHING (TABLE_NAME)",
+            nullptr,
+            2, 0
+        },
+        {
+            // SCAN_TRIPLE_KEYS
+            "SELECT ID, COALESCE(S_URI, S_BLANK), IIF(S_URI IS NULL, 2, 1), "
+            "P_URI, COALESCE(O_URI, O_BLANK, O_LITERAL), "
+            "IIF(O_URI IS NOT NULL, 1, IIF(O_BLANK IS NOT NULL, 2, 3)), "
+            "C_URI FROM TRIPLE WHERE ID > ?",
+            nullptr,
+            1, 7
+        },
+        {
+            // SCAN_TRIPLE_KEYS_UNIFIED
+            "SELECT ID, S_ID, S_KIND, P_URI, O_ID, O_KIND, C_URI "
+            "FROM TRIPLE WHERE ID > ?",
+            nullptr,
+            1, 7
+        },
+        {
+            // GET_TRIPLE_SEQUENCE
+            "SELECT GEN_ID(SEQ_TRIPLE, 0) FROM RDB$DATABASE",
+            nullptr,
+            0, 1
+        },
+        {
+            // GET_RESOURCE_IDS
+            "SELECT ID, URI FROM RESOURCE WHERE URI IN ("
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?)",
+            nullptr,
+            32, 2
+        },
+        {
+            // GET_RESOURCE_IDS_HASH
+            "SELECT ID, URI FROM RESOURCE WHERE URI_HASH IN ("
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?)",
+            nullptr,
+            32, 2
+        },
+        {
+            // GET_BNODE_IDS
+            "SELECT ID, NAME FROM BNODE WHERE NAME IN ("
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?)",
+            nullptr,
+            32, 2
+        },
+        {
+            // GET_LITERAL_IDS
+            "SELECT l.ID, l.VAL, l.LANGUAGE, d.URI FROM LITERAL l "
+            "LEFT JOIN RESOURCE d ON l.DATATYPE = d.ID "
+            "WHERE l.VAL IN ("
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?)",
+            nullptr,
+            32, 4
+        },
+        {
+            // GET_LITERAL_IDS_HASH
+            "SELECT l.ID, l.VAL, l.LANGUAGE, d.URI FROM LITERAL l "
+            "LEFT JOIN RESOURCE d ON l.DATATYPE = d.ID "
+            "WHERE l.VAL_HASH IN ("
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?, "
+            "?, ?, ?, ?, ?, ?, ?, ?)",
+            nullptr,
+            32, 4
+        },
+        {
+            // DELETE_ORPHAN_CONTEXTS_LOGGED
+            "DELETE FROM CONTEXT c "
+            "WHERE NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.C_URI = c.ID) "
+            "AND NOT EXISTS (SELECT 1 FROM TRIPLE_LOG g WHERE g.C_URI = c.ID)",
+            nullptr,
+            0, 0
+        },
+        {
+            // GET_TRIPLE_LOG_CHANGES
+            "SELECT FIRST ? g.SEQ, g.OP, rs.URI, bs.NAME, rp.URI, "
+            "ro.URI, bo.NAME, lo.VAL, lo.LANGUAGE, ldt.URI, c.URI, "
+            "IIF(lo.ID IS NOT NULL AND lo.VAL IS NULL, lo.ID, NULL) "
+            "FROM TRIPLE_LOG g "
+            "LEFT JOIN RESOURCE rs ON g.S_KIND = 1 AND g.S_ID = rs.ID "
+            "LEFT JOIN BNODE bs ON g.S_KIND = 2 AND g.S_ID = bs.ID "
+            "JOIN RESOURCE rp ON g.P_URI = rp.ID "
+            "LEFT JOIN RESOURCE ro ON g.O_KIND = 1 AND g.O_ID = ro.ID "
+            "LEFT JOIN BNODE bo ON g.O_KIND = 2 AND g.O_ID = bo.ID "
+            "LEFT JOIN LITERAL lo ON g.O_KIND = 3 AND g.O_ID = lo.ID "
+            "LEFT JOIN RESOURCE ldt ON lo.DATATYPE = ldt.ID "
+            "LEFT JOIN CONTEXT c ON g.C_URI = c.ID "
+            "WHERE g.SEQ > ? ORDER BY g.SEQ",
+            nullptr,
+            2, 12
+        },
+        {
+            // GET_TRIPLE_LOG_WATERMARK
+            "SELECT COALESCE(MAX(SEQ), 0) FROM TRIPLE_LOG",
+            nullptr,
+            0, 1
+        },
+        {
+            // TRIM_TRIPLE_LOG
+            "DELETE FROM TRIPLE_LOG WHERE SEQ <= ?",
+            nullptr,
+            1, 0
+        },
+        {
+            // GET_DATABASE_ID
+            "SELECT CAST(MON$CREATION_DATE AS VARCHAR(32)) FROM MON$DATABASE",
             nullptr,
             0, 1
         },
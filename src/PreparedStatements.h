@@ -14,6 +14,9 @@
 #ifndef PREPAREDSTATEMENTS_H_
 #define PREPAREDSTATEMENTS_H_
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <string>
 #include <vector>
 #include <cassert>
@@ -63,13 +66,84 @@ enum PrepStatementIndex : unsigned int
     SELECT_TRIPLE_9,
     SELECT_TRIPLE_10,
     SELECT_TRIPLE_11,
+    SELECT_TRIPLE_SPOC_0,
+    SELECT_TRIPLE_SPOC_1,
+    SELECT_TRIPLE_SPOC_2,
+    SELECT_TRIPLE_SPOC_3,
+    SELECT_TRIPLE_SPOC_4,
+    SELECT_TRIPLE_SPOC_5,
+    SELECT_TRIPLE_SPOC_6,
+    SELECT_TRIPLE_SPOC_7,
+    SELECT_TRIPLE_SPOC_8,
+    SELECT_TRIPLE_SPOC_9,
+    SELECT_TRIPLE_SPOC_10,
+    SELECT_TRIPLE_SPOC_11,
     INSERT_TRIPLE,
     GET_TRIPLE_COUNT,
     DELETE_TRIPLE,
     GET_CONTEXTS,
+    INSERT_RESOURCE_UNIFIED,
+    INSERT_BNODE_UNIFIED,
+    INSERT_LITERAL_UNIFIED,
+    SELECT_TRIPLE_UNIFIED_0,
+    SELECT_TRIPLE_UNIFIED_1,
+    INSERT_TRIPLE_UNIFIED,
+    GET_RESOURCE_ID_HASH,
+    INSERT_RESOURCE_HASH,
+    INSERT_RESOURCE_UNIFIED_HASH,
+    GET_LITERAL_ID_1_HASH,
+    GET_LITERAL_ID_2_LANG_HASH,
+    GET_LITERAL_ID_3_DT_HASH,
+    INSERT_LITERAL_HASH,
+    INSERT_LITERAL_UNIFIED_HASH,
+    GET_LONG_LITERAL_ID_1,
+    GET_LONG_LITERAL_ID_2_LANG,
+    GET_LONG_LITERAL_ID_3_DT,
+    INSERT_LONG_LITERAL,
+    INSERT_LONG_LITERAL_UNIFIED,
+    GET_LONG_LITERAL_VAL,
+    GET_TRIPLE_COUNT_MAINTAINED,
+    GET_CONTEXT_TRIPLE_COUNT,
+    GET_CONTEXT_TRIPLE_COUNT_MAINTAINED,
+    GET_CONTEXTS_MAINTAINED,
+    GET_TRIPLE_COUNT_ROWS,
+    DELETE_CONTEXT_TRIPLES,
+    DELETE_DEFAULT_CONTEXT_TRIPLES,
+    DELETE_ORPHAN_CONTEXTS,
+    DELETE_TRIPLE_BATCH,
+    GET_NODE_GC_POSITION,
+    SET_NODE_GC_POSITION,
+    SCAN_TRIPLE_KEYS,
+    SCAN_TRIPLE_KEYS_UNIFIED,
+    GET_TRIPLE_SEQUENCE,
+    GET_RESOURCE_IDS,
+    GET_RESOURCE_IDS_HASH,
+    GET_BNODE_IDS,
+    GET_LITERAL_IDS,
+    GET_LITERAL_IDS_HASH,
+    DELETE_ORPHAN_CONTEXTS_LOGGED,
+    GET_TRIPLE_LOG_CHANGES,
+    GET_TRIPLE_LOG_WATERMARK,
+    TRIM_TRIPLE_LOG,
+    GET_DATABASE_ID,
     LAST_PREP_STATEMENT_IDX
 };
 
+/** the PrepStatementIndex names, for reporting */
+extern const char * const PREP_STATEMENT_NAMES[LAST_PREP_STATEMENT_IDX];
+
+/**
+ * whether the schema objects a statement refers to exist in a database with
+ * the given SchemaFlags
+ */
+bool prep_statement_applies(PrepStatementIndex psi, unsigned int schemaFlags);
+
+/** number of statement IDs DELETE_TRIPLE_BATCH takes */
+constexpr unsigned int DELETE_TRIPLE_BATCH_SIZE = 128;
+
+/** number of node keys the GET_*_IDS statements take */
+constexpr unsigned int NODE_LOOKUP_BATCH_SIZE = 32;
+
 struct PreparedStatements
 {
     PreparedStatement statements_[LAST_PREP_STATEMENT_IDX];
@@ -84,18 +158,40 @@ inline PreparedStatement &PreparedStatements::get(PrepStatementIndex psi)
     return statements_[psi];
 }
 
+/**
+ * Pool of the prepared statements of one match query shape. Each open
+ * iterator uses its own statement, released statements are kept idle for
+ * reuse (up to a limit and for a limited time).
+ */
 struct MatchPreparedStatement
 {
-    using UserTag = void*;
-    using StatementTagPair = std::pair<DbStatement*, UserTag>;
-
-    vector<StatementTagPair> statements;
+    struct PooledStatement
+    {
+        DbStatement *st;
+        // when it was last released, idle statements are evicted by age
+        std::chrono::steady_clock::time_point released;
+    };
+
+    // free list, the most recently released statement is at the back
+    std::deque<PooledStatement*> idle;
     string sql;
+
+    // statements prepared, acquisitions served from the free list,
+    // statements in use now and at most
+    uint64_t prepares;
+    uint64_t reuses;
+    unsigned int inUse;
+    unsigned int peakInUse;
+
+    MatchPreparedStatement()
+            : idle(), sql(), prepares(0), reuses(0), inUse(0), peakInUse(0)
+    {
+    }
 };
 
 struct MatchPreparedStatements
 {
-    static constexpr unsigned int MATCH_STATEMENTS_COUNT = 72;
+    static constexpr unsigned int MATCH_STATEMENTS_COUNT = 84;
     MatchPreparedStatement statements_[MATCH_STATEMENTS_COUNT];
 
     MatchPreparedStatement &get(unsigned int index);
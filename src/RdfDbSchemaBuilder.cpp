@@ -13,13 +13,19 @@
  */
 
 #include "RdfDbSchemaBuilder.h"
+#include "NodeHash.h"
 #include "fb/DbConnection.h"
 #include "fb/DbTransaction.h"
 #include "fb/DbStatement.h"
 #include "fb/DbRowProxy.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
 #include <string>
 #include <string.h>
-#include <cassert>
 
 namespace rdf
 {
@@ -29,33 +35,54 @@ struct DbObject
     const char *name;
     const char *type;
     const char *sql;
+    /** create the object only if all these SchemaFlags are requested */
+    unsigned int onlyIf;
+    /** don't create the object if any of these SchemaFlags is requested */
+    unsigned int unless;
 };
 
 static DbObject db_schema[] = {
 {
     "SEQ_RESOURCE",
     "SEQUENCE",
-    R"(CREATE SEQUENCE SEQ_RESOURCE)"
+    R"(CREATE SEQUENCE SEQ_RESOURCE)",
+    SCHEMA_DEFAULT,
+    SCHEMA_UNIFIED_NODES
 },
 {
     "SEQ_LITERAL",
     "SEQUENCE",
-    R"(CREATE SEQUENCE SEQ_LITERAL)"
+    R"(CREATE SEQUENCE SEQ_LITERAL)",
+    SCHEMA_DEFAULT,
+    SCHEMA_UNIFIED_NODES
 },
 {
     "SEQ_BNODE",
     "SEQUENCE",
-    R"(CREATE SEQUENCE SEQ_BNODE)"
+    R"(CREATE SEQUENCE SEQ_BNODE)",
+    SCHEMA_DEFAULT,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "SEQ_NODE",
+    "SEQUENCE",
+    R"(CREATE SEQUENCE SEQ_NODE)",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
 },
 {
     "SEQ_TRIPLE",
     "SEQUENCE",
-    R"(CREATE SEQUENCE SEQ_TRIPLE)"
+    R"(CREATE SEQUENCE SEQ_TRIPLE)",
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
 },
 {
     "SEQ_CONTEXT",
     "SEQUENCE",
-    R"(CREATE SEQUENCE SEQ_CONTEXT)"
+    R"(CREATE SEQUENCE SEQ_CONTEXT)",
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
 },
 {
     "RESOURCE",
@@ -66,7 +93,9 @@ static DbObject db_schema[] = {
     URI VARCHAR(1024) NOT NULL,
     CONSTRAINT PK_RESOURCE PRIMARY KEY(ID),
     CONSTRAINT UQ_RESOURCE_URI UNIQUE (URI)
-))"
+))",
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
 },
 {
     "CONTEXT",
@@ -77,7 +106,9 @@ static DbObject db_schema[] = {
     URI VARCHAR(1024) NOT NULL,
     CONSTRAINT PK_CONTEXT PRIMARY KEY(ID),
     CONSTRAINT UQ_CONTEXT_URI UNIQUE (URI)
-))"
+))",
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
 },
 {
     "LITERAL",
@@ -96,7 +127,54 @@ static DbObject db_schema[] = {
         CHECK ((LANGUAGE IS NULL AND DATATYPE IS NULL) OR
                (LANGUAGE IS NOT NULL AND DATATYPE IS NULL) OR
                (LANGUAGE IS NULL AND DATATYPE IS NOT NULL))
-))"
+))",
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
+},
+{
+    "RESOURCE.URI_HASH",
+    "COLUMN",
+    R"(ALTER TABLE RESOURCE ADD URI_HASH BIGINT)",
+    SCHEMA_HASH_LOOKUP,
+    SCHEMA_DEFAULT
+},
+{
+    "LITERAL.VAL_HASH",
+    "COLUMN",
+    R"(ALTER TABLE LITERAL ADD VAL_HASH BIGINT)",
+    SCHEMA_HASH_LOOKUP,
+    SCHEMA_DEFAULT
+},
+{
+    "LITERAL.VAL_BLOB",
+    "COLUMN",
+    R"(ALTER TABLE LITERAL ADD VAL_BLOB BLOB SUB_TYPE TEXT,
+    ALTER VAL DROP NOT NULL)",
+    SCHEMA_LONG_LITERALS | SCHEMA_HASH_LOOKUP,
+    SCHEMA_DEFAULT
+},
+{
+    "CK_LITERAL_VAL",
+    "CONSTRAINT",
+    R"(ALTER TABLE LITERAL ADD CONSTRAINT CK_LITERAL_VAL
+    CHECK ((VAL IS NOT NULL AND VAL_BLOB IS NULL) OR
+           (VAL IS NULL AND VAL_BLOB IS NOT NULL)))",
+    SCHEMA_LONG_LITERALS | SCHEMA_HASH_LOOKUP,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_RESOURCE_URI_HASH",
+    "INDEX",
+    R"(CREATE INDEX IDX_RESOURCE_URI_HASH ON RESOURCE (URI_HASH))",
+    SCHEMA_HASH_LOOKUP,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_LITERAL_VAL_HASH",
+    "INDEX",
+    R"(CREATE INDEX IDX_LITERAL_VAL_HASH ON LITERAL (VAL_HASH))",
+    SCHEMA_HASH_LOOKUP,
+    SCHEMA_DEFAULT
 },
 {
     "BNODE",
@@ -107,7 +185,9 @@ static DbObject db_schema[] = {
     NAME VARCHAR(64) NOT NULL,
     CONSTRAINT PK_BNODE PRIMARY KEY(ID),
     CONSTRAINT UQ_BNODE_NAME UNIQUE (NAME)
-))"
+))",
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
 },
 {
     "TRIPLE",
@@ -146,42 +226,143 @@ static DbObject db_schema[] = {
         CHECK ((O_URI IS NOT NULL AND O_BLANK IS NULL AND O_LITERAL IS NULL) OR
                (O_URI IS NULL AND O_BLANK IS NOT NULL AND O_LITERAL IS NULL) OR
                (O_URI IS NULL AND O_BLANK IS NULL AND O_LITERAL IS NOT NULL))
-))"
+))",
+    SCHEMA_DEFAULT,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "TRIPLE",
+    "TABLE",
+    R"(CREATE TABLE TRIPLE
+(
+    ID BIGINT NOT NULL,
+    S_ID BIGINT,
+    S_KIND SMALLINT,
+    P_URI BIGINT NOT NULL,
+    O_ID BIGINT,
+    O_KIND SMALLINT,
+    C_URI BIGINT DEFAULT NULL,
+    CONSTRAINT PK_TRIPLE PRIMARY KEY(ID),
+    CONSTRAINT FK_TRIPLE_P_URI
+        FOREIGN KEY (P_URI) REFERENCES RESOURCE (ID),
+    CONSTRAINT FK_TRIPLE_C_URI
+        FOREIGN KEY (C_URI) REFERENCES CONTEXT (ID),
+    CONSTRAINT CK_TRIPLE_SUBJ
+        CHECK (S_ID IS NOT NULL AND S_KIND IN (1, 2)),
+    CONSTRAINT CK_TRIPLE_OBJ
+        CHECK (O_ID IS NOT NULL AND O_KIND IN (1, 2, 3))
+))",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
 },
 {
     "IDX_TRIPLE_S_URI",
     "INDEX",
-    R"(CREATE INDEX IDX_TRIPLE_S_URI ON TRIPLE (S_URI))"
+    R"(CREATE INDEX IDX_TRIPLE_S_URI ON TRIPLE (S_URI))",
+    SCHEMA_DEFAULT,
+    SCHEMA_COMPOSITE_INDEXES | SCHEMA_UNIFIED_NODES
 },
 {
     "IDX_TRIPLE_S_BLANK",
     "INDEX",
-    R"(CREATE INDEX IDX_TRIPLE_S_BLANK ON TRIPLE (S_BLANK))"
+    R"(CREATE INDEX IDX_TRIPLE_S_BLANK ON TRIPLE (S_BLANK))",
+    SCHEMA_DEFAULT,
+    SCHEMA_COMPOSITE_INDEXES | SCHEMA_UNIFIED_NODES
 },
 {
     "IDX_TRIPLE_P_URI",
     "INDEX",
-    R"(CREATE INDEX IDX_TRIPLE_P_URI ON TRIPLE (P_URI))"
+    R"(CREATE INDEX IDX_TRIPLE_P_URI ON TRIPLE (P_URI))",
+    SCHEMA_DEFAULT,
+    SCHEMA_COMPOSITE_INDEXES | SCHEMA_UNIFIED_NODES
 },
 {
     "IDX_TRIPLE_O_URI",
     "INDEX",
-    R"(CREATE INDEX IDX_TRIPLE_O_URI ON TRIPLE (O_URI))"
+    R"(CREATE INDEX IDX_TRIPLE_O_URI ON TRIPLE (O_URI))",
+    SCHEMA_DEFAULT,
+    SCHEMA_COMPOSITE_INDEXES | SCHEMA_UNIFIED_NODES
 },
 {
     "IDX_TRIPLE_O_BLANK",
     "INDEX",
-    R"(CREATE INDEX IDX_TRIPLE_O_BLANK ON TRIPLE (O_BLANK))"
+    R"(CREATE INDEX IDX_TRIPLE_O_BLANK ON TRIPLE (O_BLANK))",
+    SCHEMA_DEFAULT,
+    SCHEMA_COMPOSITE_INDEXES | SCHEMA_UNIFIED_NODES
 },
 {
     "IDX_TRIPLE_O_LITERAL",
     "INDEX",
-    R"(CREATE INDEX IDX_TRIPLE_O_LITERAL ON TRIPLE (O_LITERAL))"
+    R"(CREATE INDEX IDX_TRIPLE_O_LITERAL ON TRIPLE (O_LITERAL))",
+    SCHEMA_DEFAULT,
+    SCHEMA_COMPOSITE_INDEXES | SCHEMA_UNIFIED_NODES
 },
 {
     "IDX_TRIPLE_C_URI",
     "INDEX",
-    R"(CREATE INDEX IDX_TRIPLE_C_URI ON TRIPLE (C_URI))"
+    R"(CREATE INDEX IDX_TRIPLE_C_URI ON TRIPLE (C_URI))",
+    SCHEMA_DEFAULT,
+    SCHEMA_COMPOSITE_INDEXES | SCHEMA_UNIFIED_NODES
+},
+{
+    "IDX_TRIPLE_SPOC",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_SPOC ON TRIPLE
+    (S_URI, S_BLANK, P_URI, O_URI, O_BLANK, O_LITERAL, C_URI))",
+    SCHEMA_COMPOSITE_INDEXES,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "IDX_TRIPLE_POS",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_POS ON TRIPLE
+    (P_URI, O_URI, O_BLANK, O_LITERAL, S_URI, S_BLANK))",
+    SCHEMA_COMPOSITE_INDEXES,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "IDX_TRIPLE_OSP",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_OSP ON TRIPLE
+    (O_URI, O_BLANK, O_LITERAL, S_URI, S_BLANK, P_URI))",
+    SCHEMA_COMPOSITE_INDEXES,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "IDX_TRIPLE_CSPO",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_CSPO ON TRIPLE
+    (C_URI, S_URI, S_BLANK, P_URI, O_URI, O_BLANK, O_LITERAL))",
+    SCHEMA_COMPOSITE_INDEXES,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "IDX_TRIPLE_SPOC",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_SPOC ON TRIPLE (S_ID, P_URI, O_ID, C_URI))",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_TRIPLE_POS",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_POS ON TRIPLE (P_URI, O_ID, S_ID))",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_TRIPLE_OSP",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_OSP ON TRIPLE (O_ID, S_ID, P_URI))",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_TRIPLE_CSPO",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_CSPO ON TRIPLE (C_URI, S_ID, P_URI, O_ID))",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
 },
 {
     "STATEMENTS_N3",
@@ -203,7 +384,9 @@ LEFT JOIN RESOURCE ro ON r.O_URI = ro.ID
 LEFT JOIN BNODE bo ON r.O_BLANK = bo.ID
 LEFT JOIN LITERAL lo ON r.O_LITERAL = lo.ID
 LEFT JOIN RESOURCE ldt ON lo.DATATYPE = ldt.ID
-LEFT JOIN CONTEXT c ON r.C_URI = c.ID)"
+LEFT JOIN CONTEXT c ON r.C_URI = c.ID)",
+    SCHEMA_DEFAULT,
+    SCHEMA_UNIFIED_NODES
 },
 {
     "STATEMENTS",
@@ -227,7 +410,9 @@ LEFT JOIN RESOURCE ro ON r.O_URI = ro.ID
 LEFT JOIN BNODE bo ON r.O_BLANK = bo.ID
 LEFT JOIN LITERAL lo ON r.O_LITERAL = lo.ID
 LEFT JOIN RESOURCE ldt ON lo.DATATYPE = ldt.ID
-LEFT JOIN CONTEXT c ON r.C_URI = c.ID)"
+LEFT JOIN CONTEXT c ON r.C_URI = c.ID)",
+    SCHEMA_DEFAULT,
+    SCHEMA_UNIFIED_NODES
 },
 {
     "STATEMENT_DETAILS",
@@ -249,12 +434,295 @@ LEFT JOIN RESOURCE ro ON r.O_URI = ro.ID
 LEFT JOIN BNODE bo ON r.O_BLANK = bo.ID
 LEFT JOIN LITERAL lo ON r.O_LITERAL = lo.ID
 LEFT JOIN RESOURCE ldt ON lo.DATATYPE = ldt.ID
-LEFT JOIN CONTEXT c ON r.C_URI = c.ID)"
+LEFT JOIN CONTEXT c ON r.C_URI = c.ID)",
+    SCHEMA_DEFAULT,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "STATEMENTS_N3",
+    "VIEW",
+    R"(CREATE VIEW STATEMENTS_N3 as
+SELECT r.ID as statement_id,
+       coalesce('<' || rs.URI || '>', '_:' || bs.NAME) as subject,
+       '<' || rp.URI || '>' as predicate,
+       coalesce('<' || ro.URI || '>', '_:' || bo.NAME,
+       '"' || lo.VAL || '"' ||
+           coalesce('@' || lo.LANGUAGE, '') ||
+           coalesce('^^' || '<' || ldt.URI || '>', '')) as object,
+       '<' || c.URI || '>' as context
+FROM TRIPLE r
+LEFT JOIN RESOURCE rs ON r.S_KIND = 1 AND r.S_ID = rs.ID
+LEFT JOIN BNODE bs ON r.S_KIND = 2 AND r.S_ID = bs.ID
+JOIN RESOURCE rp ON r.P_URI = rp.id
+LEFT JOIN RESOURCE ro ON r.O_KIND = 1 AND r.O_ID = ro.ID
+LEFT JOIN BNODE bo ON r.O_KIND = 2 AND r.O_ID = bo.ID
+LEFT JOIN LITERAL lo ON r.O_KIND = 3 AND r.O_ID = lo.ID
+LEFT JOIN RESOURCE ldt ON lo.DATATYPE = ldt.ID
+LEFT JOIN CONTEXT c ON r.C_URI = c.ID)",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
+},
+{
+    "STATEMENTS",
+    "VIEW",
+    R"(CREATE VIEW STATEMENTS as
+SELECT r.ID as statement_id,
+       rs.URI as s_uri,
+       bs.NAME as s_blank,
+       rp.URI as predicate,
+       ro.URI as o_uri,
+       bo.NAME as o_blank,
+       lo.VAL as o_literal,
+       lo.LANGUAGE as o_lit_lang,
+       ldt.URI as o_lit_dt,
+       c.URI as context
+FROM TRIPLE r
+LEFT JOIN RESOURCE rs ON r.S_KIND = 1 AND r.S_ID = rs.ID
+LEFT JOIN BNODE bs ON r.S_KIND = 2 AND r.S_ID = bs.ID
+JOIN RESOURCE rp ON r.P_URI = rp.id
+LEFT JOIN RESOURCE ro ON r.O_KIND = 1 AND r.O_ID = ro.ID
+LEFT JOIN BNODE bo ON r.O_KIND = 2 AND r.O_ID = bo.ID
+LEFT JOIN LITERAL lo ON r.O_KIND = 3 AND r.O_ID = lo.ID
+LEFT JOIN RESOURCE ldt ON lo.DATATYPE = ldt.ID
+LEFT JOIN CONTEXT c ON r.C_URI = c.ID)",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
+},
+{
+    "STATEMENT_DETAILS",
+    "VIEW",
+    R"(CREATE VIEW STATEMENT_DETAILS (STID, SID, PID, OID, CID, SUBJ, PRED, OBJ)
+AS SELECT r.ID as statement_id,
+       r.S_ID as sid,
+       r.P_URI as pid,
+       r.O_ID as oid,
+       r.C_URI as cid,
+       coalesce(rs.URI, bs.NAME) as subj,
+       rp.URI as pred,
+       coalesce(ro.URI,bo.NAME, lo.VAL || coalesce(('@' || lo.LANGUAGE), '') || coalesce('^' || lo.DATATYPE, '')) as obj
+FROM TRIPLE r
+LEFT JOIN RESOURCE rs ON r.S_KIND = 1 AND r.S_ID = rs.ID
+LEFT JOIN BNODE bs ON r.S_KIND = 2 AND r.S_ID = bs.ID
+JOIN RESOURCE rp ON r.P_URI = rp.id
+LEFT JOIN RESOURCE ro ON r.O_KIND = 1 AND r.O_ID = ro.ID
+LEFT JOIN BNODE bo ON r.O_KIND = 2 AND r.O_ID = bo.ID
+LEFT JOIN LITERAL lo ON r.O_KIND = 3 AND r.O_ID = lo.ID
+LEFT JOIN RESOURCE ldt ON lo.DATATYPE = ldt.ID
+LEFT JOIN CONTEXT c ON r.C_URI = c.ID)",
+    SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
+},
+{
+    "NODE_GC_STATE",
+    "TABLE",
+    R"(CREATE TABLE NODE_GC_STATE
+(
+    TABLE_NAME VARCHAR(31) NOT NULL,
+    LAST_ID BIGINT NOT NULL,
+    CONSTRAINT PK_NODE_GC_STATE PRIMARY KEY(TABLE_NAME)
+))",
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
+},
+{
+    // the attachments loading with inactive TRIPLE indexes
+    "FASTLOAD_STATE",
+    "TABLE",
+    R"(CREATE TABLE FASTLOAD_STATE
+(
+    ATTACHMENT_ID BIGINT NOT NULL,
+    STARTED TIMESTAMP NOT NULL,
+    CONSTRAINT PK_FASTLOAD_STATE PRIMARY KEY(ATTACHMENT_ID)
+))",
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
+},
+{
+    "TRIPLE_COUNT",
+    "TABLE",
+    R"(CREATE TABLE TRIPLE_COUNT
+(
+    C_URI BIGINT,
+    DELTA BIGINT NOT NULL,
+    LAST_MODIFIED TIMESTAMP NOT NULL
+))",
+    SCHEMA_TRIPLE_COUNT,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_TRIPLE_COUNT_C_URI",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_COUNT_C_URI ON TRIPLE_COUNT (C_URI))",
+    SCHEMA_TRIPLE_COUNT,
+    SCHEMA_DEFAULT
+},
+{
+    "TRG_TRIPLE_COUNT_INSERT",
+    "TRIGGER",
+    R"(CREATE TRIGGER TRG_TRIPLE_COUNT_INSERT FOR TRIPLE AFTER INSERT AS
+BEGIN
+    INSERT INTO TRIPLE_COUNT (C_URI, DELTA, LAST_MODIFIED)
+    VALUES (NEW.C_URI, 1, CURRENT_TIMESTAMP);
+END)",
+    SCHEMA_TRIPLE_COUNT,
+    SCHEMA_DEFAULT
+},
+{
+    "TRG_TRIPLE_COUNT_DELETE",
+    "TRIGGER",
+    R"(CREATE TRIGGER TRG_TRIPLE_COUNT_DELETE FOR TRIPLE AFTER DELETE AS
+BEGIN
+    INSERT INTO TRIPLE_COUNT (C_URI, DELTA, LAST_MODIFIED)
+    VALUES (OLD.C_URI, -1, CURRENT_TIMESTAMP);
+END)",
+    SCHEMA_TRIPLE_COUNT,
+    SCHEMA_DEFAULT
+},
+{
+    "CONTEXT_STATS",
+    "VIEW",
+    R"(CREATE VIEW CONTEXT_STATS (C_URI, TRIPLE_COUNT, LAST_MODIFIED) AS
+SELECT C_URI, SUM(DELTA), MAX(LAST_MODIFIED)
+FROM TRIPLE_COUNT
+GROUP BY C_URI)",
+    SCHEMA_TRIPLE_COUNT,
+    SCHEMA_DEFAULT
+},
+{
+    "SEQ_TRIPLE_LOG",
+    "SEQUENCE",
+    "CREATE SEQUENCE SEQ_TRIPLE_LOG",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_DEFAULT
+},
+{
+    "TRIPLE_LOG",
+    "TABLE",
+    R"(CREATE TABLE TRIPLE_LOG
+(
+    SEQ BIGINT NOT NULL,
+    OP SMALLINT NOT NULL,
+    STATEMENT_ID BIGINT NOT NULL,
+    S_KIND SMALLINT NOT NULL,
+    S_ID BIGINT NOT NULL,
+    P_URI BIGINT NOT NULL,
+    O_KIND SMALLINT NOT NULL,
+    O_ID BIGINT NOT NULL,
+    C_URI BIGINT,
+    LOGGED_AT TIMESTAMP NOT NULL,
+    CONSTRAINT PK_TRIPLE_LOG PRIMARY KEY (SEQ)
+))",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_TRIPLE_LOG_S_ID",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_LOG_S_ID ON TRIPLE_LOG (S_ID))",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_TRIPLE_LOG_P_URI",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_LOG_P_URI ON TRIPLE_LOG (P_URI))",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_TRIPLE_LOG_O_ID",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_LOG_O_ID ON TRIPLE_LOG (O_ID))",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_DEFAULT
+},
+{
+    "IDX_TRIPLE_LOG_C_URI",
+    "INDEX",
+    R"(CREATE INDEX IDX_TRIPLE_LOG_C_URI ON TRIPLE_LOG (C_URI))",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_DEFAULT
+},
+{
+    // MAX(SEQ) of the change watermark
+    "IDX_TRIPLE_LOG_SEQ_DESC",
+    "INDEX",
+    R"(CREATE DESCENDING INDEX IDX_TRIPLE_LOG_SEQ_DESC ON TRIPLE_LOG (SEQ))",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_DEFAULT
+},
+{
+    "TRG_TRIPLE_LOG_INSERT",
+    "TRIGGER",
+    R"(CREATE TRIGGER TRG_TRIPLE_LOG_INSERT FOR TRIPLE AFTER INSERT AS
+BEGIN
+    INSERT INTO TRIPLE_LOG (SEQ, OP, STATEMENT_ID, S_KIND, S_ID, P_URI,
+                            O_KIND, O_ID, C_URI, LOGGED_AT)
+    VALUES (NEXT VALUE FOR SEQ_TRIPLE_LOG, 1, NEW.ID,
+            IIF(NEW.S_URI IS NOT NULL, 1, 2),
+            COALESCE(NEW.S_URI, NEW.S_BLANK),
+            NEW.P_URI,
+            IIF(NEW.O_URI IS NOT NULL, 1,
+                IIF(NEW.O_BLANK IS NOT NULL, 2, 3)),
+            COALESCE(NEW.O_URI, NEW.O_BLANK, NEW.O_LITERAL),
+            NEW.C_URI, CURRENT_TIMESTAMP);
+END)",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "TRG_TRIPLE_LOG_DELETE",
+    "TRIGGER",
+    R"(CREATE TRIGGER TRG_TRIPLE_LOG_DELETE FOR TRIPLE AFTER DELETE AS
+BEGIN
+    INSERT INTO TRIPLE_LOG (SEQ, OP, STATEMENT_ID, S_KIND, S_ID, P_URI,
+                            O_KIND, O_ID, C_URI, LOGGED_AT)
+    VALUES (NEXT VALUE FOR SEQ_TRIPLE_LOG, -1, OLD.ID,
+            IIF(OLD.S_URI IS NOT NULL, 1, 2),
+            COALESCE(OLD.S_URI, OLD.S_BLANK),
+            OLD.P_URI,
+            IIF(OLD.O_URI IS NOT NULL, 1,
+                IIF(OLD.O_BLANK IS NOT NULL, 2, 3)),
+            COALESCE(OLD.O_URI, OLD.O_BLANK, OLD.O_LITERAL),
+            OLD.C_URI, CURRENT_TIMESTAMP);
+END)",
+    SCHEMA_TRIPLE_LOG,
+    SCHEMA_UNIFIED_NODES
+},
+{
+    "TRG_TRIPLE_LOG_INSERT",
+    "TRIGGER",
+    R"(CREATE TRIGGER TRG_TRIPLE_LOG_INSERT FOR TRIPLE AFTER INSERT AS
+BEGIN
+    INSERT INTO TRIPLE_LOG (SEQ, OP, STATEMENT_ID, S_KIND, S_ID, P_URI,
+                            O_KIND, O_ID, C_URI, LOGGED_AT)
+    VALUES (NEXT VALUE FOR SEQ_TRIPLE_LOG, 1, NEW.ID,
+            NEW.S_KIND, NEW.S_ID, NEW.P_URI, NEW.O_KIND, NEW.O_ID,
+            NEW.C_URI, CURRENT_TIMESTAMP);
+END)",
+    SCHEMA_TRIPLE_LOG | SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
 },
 {
+    "TRG_TRIPLE_LOG_DELETE",
+    "TRIGGER",
+    R"(CREATE TRIGGER TRG_TRIPLE_LOG_DELETE FOR TRIPLE AFTER DELETE AS
+BEGIN
+    INSERT INTO TRIPLE_LOG (SEQ, OP, STATEMENT_ID, S_KIND, S_ID, P_URI,
+                            O_KIND, O_ID, C_URI, LOGGED_AT)
+    VALUES (NEXT VALUE FOR SEQ_TRIPLE_LOG, -1, OLD.ID,
+            OLD.S_KIND, OLD.S_ID, OLD.P_URI, OLD.O_KIND, OLD.O_ID,
+            OLD.C_URI, CURRENT_TIMESTAMP);
+END)",
+    SCHEMA_TRIPLE_LOG | SCHEMA_UNIFIED_NODES,
+    SCHEMA_DEFAULT
+},
+{
+    nullptr,
     nullptr,
     nullptr,
-    nullptr
+    SCHEMA_DEFAULT,
+    SCHEMA_DEFAULT
 }
 };
 
@@ -263,17 +731,61 @@ using fb::DbConnection;
 using fb::DbStatement;
 using fb::DbTransaction;
 
-void create_firebird_rdf_db(const char *dbName, const char *server,
-                            const char *userName, const char *userPassword)
+/** compute the node_hash() of rows which don't have it yet */
+static void fill_hash_column(DbConnection &db, DbTransaction &tr,
+                             const char *table, const char *column,
+                             const char *hashColumn)
 {
-    DbConnection db{dbName, server, userName, userPassword};
-    DbTransaction tr{db.nativeHandle(), 1};
+    string q = "SELECT ID, ";
+    q += column;
+    q += " FROM ";
+    q += table;
+    q += " WHERE ";
+    q += hashColumn;
+    q += " IS NULL";
+    DbStatement sel = db.createStatement(q.c_str(), &tr);
+
+    q = "UPDATE ";
+    q += table;
+    q += " SET ";
+    q += hashColumn;
+    q += "=? WHERE ID=?";
+    DbStatement upd = db.createStatement(q.c_str(), &tr);
 
+    string val;
+    for (DbStatement::Iterator i = sel.iterate(); i != sel.end(); ++i) {
+        fb::DbRowProxy row = *i;
+        val = row.getText(1);
+        upd.reset();
+        upd.setInt(1, node_hash(val.data(), val.size()));
+        upd.setInt(2, row.getInt64(0));
+        upd.execute();
+    }
+}
+
+/**
+ * create the objects of db_schema which don't exist yet, only the one
+ * called onlyName if it is given
+ */
+static void create_schema_objects(DbConnection &db, DbTransaction &tr,
+                                  unsigned int schemaFlags,
+                                  const char *onlyName = nullptr)
+{
     for (DbObject &obj : db_schema) {
         if (!obj.name) {
             break;
         }
 
+        if (onlyName && strcmp(obj.name, onlyName) != 0) {
+            continue;
+        }
+
+        if ((obj.onlyIf & schemaFlags) != obj.onlyIf ||
+            (obj.unless & schemaFlags) != 0) {
+            // object belongs to an optional schema feature
+            continue;
+        }
+
         const char *checkTable = nullptr;
         const char *whereField = nullptr;
         bool isRelation = false;
@@ -289,6 +801,16 @@ void create_firebird_rdf_db(const char *dbName, const char *server,
         } else if (strcasecmp(obj.type, "INDEX") == 0) {
             checkTable = "RDB$INDICES";
             whereField = "RDB$INDEX_NAME";
+        } else if (strcasecmp(obj.type, "COLUMN") == 0) {
+            // column names are given as TABLE.COLUMN
+            checkTable = "RDB$RELATION_FIELDS";
+            whereField = "TRIM(RDB$RELATION_NAME) || '.' || TRIM(RDB$FIELD_NAME)";
+        } else if (strcasecmp(obj.type, "CONSTRAINT") == 0) {
+            checkTable = "RDB$RELATION_CONSTRAINTS";
+            whereField = "RDB$CONSTRAINT_NAME";
+        } else if (strcasecmp(obj.type, "TRIGGER") == 0) {
+            checkTable = "RDB$TRIGGERS";
+            whereField = "RDB$TRIGGER_NAME";
         }
 
         if (!checkTable || !whereField) {
@@ -321,6 +843,363 @@ void create_firebird_rdf_db(const char *dbName, const char *server,
     }
 }
 
+void create_missing_table(DbConnection &db, const char *name)
+{
+    DbTransaction tr{db.nativeHandle(), 1};
+    create_schema_objects(db, tr, SCHEMA_DEFAULT, name);
+    tr.commit();
+}
+
+void create_firebird_rdf_db(const char *dbName, const char *server,
+                            const char *userName, const char *userPassword,
+                            unsigned int schemaFlags)
+{
+    DbConnection db{dbName, server, userName, userPassword};
+    {
+        DbTransaction tr{db.nativeHandle(), 1};
+        create_schema_objects(db, tr, schemaFlags);
+    }
+
+    if (schemaFlags & SCHEMA_HASH_LOOKUP) {
+        // hash columns may have been added to tables which have rows
+        DbTransaction tr{db.nativeHandle(), 1};
+        fill_hash_column(db, tr, "RESOURCE", "URI", "URI_HASH");
+        fill_hash_column(db, tr, "LITERAL", "VAL", "VAL_HASH");
+    }
+
+    if (schemaFlags & SCHEMA_TRIPLE_COUNT) {
+        // the triggers only count the changes made after they were created
+        DbTransaction tr{db.nativeHandle(), 1};
+        DbStatement st = db.createStatement(
+                                "SELECT FIRST 1 DELTA FROM TRIPLE_COUNT", &tr);
+        if (!st.uniqueResult()) {
+            db.executeUpdate("INSERT INTO TRIPLE_COUNT "
+                             "(C_URI, DELTA, LAST_MODIFIED) "
+                             "SELECT C_URI, COUNT(*), CURRENT_TIMESTAMP "
+                             "FROM TRIPLE GROUP BY C_URI", &tr);
+        }
+    }
+}
+
+/** whether an interrupted migrate_to_unified_schema() left its state */
+static bool unified_migration_pending(DbConnection &db, DbTransaction &tr)
+{
+    DbStatement st = db.createStatement(
+                            "SELECT RDB$DB_KEY FROM RDB$RELATIONS "
+                            "WHERE RDB$RELATION_NAME='UNIFIED_MIGRATION'",
+                            &tr);
+    return (bool) st.uniqueResult();
+}
+
+unsigned int get_schema_flags(DbConnection &db, DbTransaction &tr)
+{
+    if (unified_migration_pending(db, tr)) {
+        throw std::runtime_error("The migration to the unified nodes layout "
+                                 "was interrupted, finish it with "
+                                 "migrate_unified_nodes='yes'");
+    }
+
+    unsigned int flags = SCHEMA_DEFAULT;
+
+    DbStatement st = db.createStatement(
+                            "SELECT RDB$DB_KEY FROM RDB$INDICES "
+                            "WHERE RDB$INDEX_NAME='IDX_TRIPLE_SPOC'", &tr);
+    if (st.uniqueResult()) {
+        flags |= SCHEMA_COMPOSITE_INDEXES;
+    }
+
+    DbStatement st2 = db.createStatement(
+                            "SELECT RDB$DB_KEY FROM RDB$RELATION_FIELDS "
+                            "WHERE RDB$RELATION_NAME='TRIPLE' "
+                            "AND RDB$FIELD_NAME='S_ID'", &tr);
+    if (st2.uniqueResult()) {
+        flags |= SCHEMA_UNIFIED_NODES;
+    }
+
+    DbStatement st3 = db.createStatement(
+                            "SELECT RDB$DB_KEY FROM RDB$INDICES "
+                            "WHERE RDB$INDEX_NAME='IDX_RESOURCE_URI_HASH'", &tr);
+    if (st3.uniqueResult()) {
+        flags |= SCHEMA_HASH_LOOKUP;
+    }
+
+    DbStatement st4 = db.createStatement(
+                            "SELECT RDB$DB_KEY FROM RDB$RELATION_FIELDS "
+                            "WHERE RDB$RELATION_NAME='LITERAL' "
+                            "AND RDB$FIELD_NAME='VAL_BLOB'", &tr);
+    if (st4.uniqueResult()) {
+        flags |= SCHEMA_LONG_LITERALS;
+    }
+
+    DbStatement st5 = db.createStatement(
+                            "SELECT RDB$DB_KEY FROM RDB$TRIGGERS "
+                            "WHERE RDB$TRIGGER_NAME='TRG_TRIPLE_COUNT_INSERT'",
+                            &tr);
+    if (st5.uniqueResult()) {
+        flags |= SCHEMA_TRIPLE_COUNT;
+    }
+
+    DbStatement st6 = db.createStatement(
+                            "SELECT RDB$DB_KEY FROM RDB$TRIGGERS "
+                            "WHERE RDB$TRIGGER_NAME='TRG_TRIPLE_LOG_INSERT'",
+                            &tr);
+    if (st6.uniqueResult()) {
+        flags |= SCHEMA_TRIPLE_LOG;
+    }
+
+    return flags;
+}
+
+static int64_t get_max_id(DbConnection &db, DbTransaction &tr,
+                          const char *table)
+{
+    string q = "SELECT COALESCE(MAX(ID), 0) FROM ";
+    q += table;
+    DbStatement st = db.createStatement(q.c_str(), &tr);
+    return st.uniqueResult().getInt64(0);
+}
+
+/** run DDL statements, each one in its own transaction */
+static void execute_ddl(DbConnection &db,
+                        std::initializer_list<const char*> statements)
+{
+    for (const char *sql : statements) {
+        DbTransaction tr{db.nativeHandle(), 1};
+        db.executeUpdate(sql, &tr);
+        tr.commit();
+    }
+}
+
+/** a DDL step of the migration */
+static std::function<void(DbTransaction&)> ddl_step(DbConnection &db,
+                                                    const char *sql)
+{
+    return [&db, sql] (DbTransaction &tr) {
+        db.executeUpdate(sql, &tr);
+    };
+}
+
+/*
+ * Firebird doesn't allow using the columns a transaction added and it
+ * can't run everything in one transaction, so the migration runs in steps.
+ * Each step is committed together with its number in UNIFIED_MIGRATION,
+ * which also keeps the ID offsets computed before any ID changed, and an
+ * interrupted migration resumes at the step which failed.
+ */
+void migrate_to_unified_schema(const char *dbName, const char *server,
+                               const char *userName, const char *userPassword)
+{
+    DbConnection db{dbName, server, userName, userPassword};
+
+    bool pending;
+    {
+        DbTransaction tr{db.nativeHandle(), 1};
+        pending = unified_migration_pending(db, tr);
+        if (!pending && (get_schema_flags(db, tr) & SCHEMA_UNIFIED_NODES)) {
+            // nothing to do
+            return;
+        }
+    }
+
+    if (!pending) {
+        execute_ddl(db, {
+            "CREATE TABLE UNIFIED_MIGRATION ("
+            "STEP INTEGER NOT NULL, "
+            "BNODE_OFFSET BIGINT NOT NULL, "
+            "LITERAL_OFFSET BIGINT NOT NULL, "
+            "NEXT_NODE_ID BIGINT NOT NULL, "
+            "TRIPLE_LOG SMALLINT NOT NULL)"
+        });
+
+        DbTransaction tr{db.nativeHandle(), 1};
+        const unsigned int flags = get_schema_flags(db, tr);
+
+        // move blank nodes and literals above the existing IDs so that
+        // node IDs become unique across the node tables
+        const int64_t maxResource = get_max_id(db, tr, "RESOURCE");
+        const int64_t maxBnode = get_max_id(db, tr, "BNODE");
+        const int64_t maxLiteral = get_max_id(db, tr, "LITERAL");
+        const int64_t bnodeOffset = std::max(maxResource, maxBnode);
+        const int64_t literalOffset = std::max(bnodeOffset + maxBnode,
+                                               maxLiteral);
+        DbStatement st = db.createStatement(
+                "INSERT INTO UNIFIED_MIGRATION (STEP, BNODE_OFFSET, "
+                "LITERAL_OFFSET, NEXT_NODE_ID, TRIPLE_LOG) "
+                "VALUES (0, ?, ?, ?, ?)", &tr);
+        st.setInt(1, bnodeOffset);
+        st.setInt(2, literalOffset);
+        st.setInt(3, literalOffset + maxLiteral);
+        st.setInt(4, (flags & SCHEMA_TRIPLE_LOG) ? 1 : 0);
+        st.execute();
+        tr.commit();
+    }
+
+    int64_t firstStep;
+    int64_t bnodeOffset;
+    int64_t literalOffset;
+    int64_t nextNodeId;
+    bool tripleLog;
+    {
+        DbTransaction tr{db.nativeHandle(), 1};
+        DbStatement st = db.createStatement(
+                "SELECT STEP, BNODE_OFFSET, LITERAL_OFFSET, NEXT_NODE_ID, "
+                "TRIPLE_LOG FROM UNIFIED_MIGRATION", &tr);
+        fb::DbRowProxy row = st.uniqueResult();
+        firstStep = row.getInt64(0);
+        bnodeOffset = row.getInt64(1);
+        literalOffset = row.getInt64(2);
+        nextNodeId = row.getInt64(3);
+        tripleLog = row.getInt64(4) != 0;
+    }
+
+    const std::vector<std::function<void(DbTransaction&)>> steps{
+        // the change log triggers read the old columns, recreated below
+        [&db, tripleLog] (DbTransaction &tr) {
+            if (tripleLog) {
+                db.executeUpdate("DROP TRIGGER TRG_TRIPLE_LOG_INSERT", &tr);
+            }
+        },
+        [&db, tripleLog] (DbTransaction &tr) {
+            if (tripleLog) {
+                db.executeUpdate("DROP TRIGGER TRG_TRIPLE_LOG_DELETE", &tr);
+            }
+        },
+        ddl_step(db, "ALTER TABLE TRIPLE ADD S_ID BIGINT, "
+                     "ADD S_KIND SMALLINT, ADD O_ID BIGINT, "
+                     "ADD O_KIND SMALLINT"),
+        // computed from the old columns, which a repeated step still has
+        [&db, bnodeOffset, literalOffset] (DbTransaction &tr) {
+            DbStatement st = db.createStatement(
+                    "UPDATE TRIPLE SET "
+                    "S_ID=COALESCE(S_URI, S_BLANK + ?), "
+                    "S_KIND=IIF(S_URI IS NOT NULL, 1, 2), "
+                    "O_ID=COALESCE(O_URI, O_BLANK + ?, O_LITERAL + ?), "
+                    "O_KIND=IIF(O_URI IS NOT NULL, 1, "
+                               "IIF(O_BLANK IS NOT NULL, 2, 3))", &tr);
+            st.setInt(1, bnodeOffset);
+            st.setInt(2, bnodeOffset);
+            st.setInt(3, literalOffset);
+            st.execute();
+        },
+        // the views and all objects built on the old columns have to go
+        ddl_step(db, "DROP VIEW STATEMENTS_N3"),
+        ddl_step(db, "DROP VIEW STATEMENTS"),
+        ddl_step(db, "DROP VIEW STATEMENT_DETAILS"),
+        [&db] (DbTransaction &tr) {
+            DbStatement st = db.createStatement(
+                    "SELECT RDB$INDEX_NAME FROM RDB$INDICES "
+                    "WHERE RDB$RELATION_NAME='TRIPLE' "
+                    "AND RDB$INDEX_NAME STARTING WITH 'IDX_TRIPLE_'", &tr);
+            string q;
+            for (DbStatement::Iterator i = st.iterate(); i != st.end(); ++i) {
+                q = "DROP INDEX ";
+                q += (*i).getText(0);
+                db.executeUpdate(q.c_str(), &tr);
+            }
+        },
+        ddl_step(db, "ALTER TABLE TRIPLE DROP CONSTRAINT CK_TRIPLE_SUBJ, "
+                     "DROP CONSTRAINT CK_TRIPLE_OBJ, "
+                     "DROP CONSTRAINT FK_TRIPLE_S_URI, "
+                     "DROP CONSTRAINT FK_TRIPLE_S_BLANK, "
+                     "DROP CONSTRAINT FK_TRIPLE_O_URI, "
+                     "DROP CONSTRAINT FK_TRIPLE_O_BLANK, "
+                     "DROP CONSTRAINT FK_TRIPLE_O_LITERAL"),
+        ddl_step(db, "ALTER TABLE TRIPLE DROP S_URI, DROP S_BLANK, "
+                     "DROP O_URI, DROP O_BLANK, DROP O_LITERAL"),
+        ddl_step(db, "ALTER TABLE TRIPLE ADD CONSTRAINT CK_TRIPLE_SUBJ "
+                     "CHECK (S_ID IS NOT NULL AND S_KIND IN (1, 2))"),
+        ddl_step(db, "ALTER TABLE TRIPLE ADD CONSTRAINT CK_TRIPLE_OBJ "
+                     "CHECK (O_ID IS NOT NULL AND O_KIND IN (1, 2, 3))"),
+        // nothing references the blank node and literal IDs any more, the
+        // step number committed with the renumbering keeps it from being
+        // repeated
+        [&db, bnodeOffset, literalOffset, tripleLog] (DbTransaction &tr) {
+            DbStatement bst = db.createStatement(
+                                    "UPDATE BNODE SET ID=ID + ?", &tr);
+            bst.setInt(1, bnodeOffset);
+            bst.execute();
+
+            DbStatement lst = db.createStatement(
+                                    "UPDATE LITERAL SET ID=ID + ?", &tr);
+            lst.setInt(1, literalOffset);
+            lst.execute();
+
+            if (tripleLog) {
+                // the logged statements refer to the renumbered nodes too
+                DbStatement gst = db.createStatement(
+                        "UPDATE TRIPLE_LOG SET "
+                        "S_ID=IIF(S_KIND=2, S_ID + ?, S_ID), "
+                        "O_ID=IIF(O_KIND=2, O_ID + ?, "
+                                 "IIF(O_KIND=3, O_ID + ?, O_ID))", &tr);
+                gst.setInt(1, bnodeOffset);
+                gst.setInt(2, bnodeOffset);
+                gst.setInt(3, literalOffset);
+                gst.execute();
+            }
+        },
+        ddl_step(db, "DROP SEQUENCE SEQ_RESOURCE"),
+        ddl_step(db, "DROP SEQUENCE SEQ_BNODE"),
+        ddl_step(db, "DROP SEQUENCE SEQ_LITERAL"),
+        // new sequence, indexes, views and change log triggers
+        [&db, tripleLog] (DbTransaction &tr) {
+            create_schema_objects(db, tr, SCHEMA_UNIFIED_NODES |
+                                  (tripleLog ? (int) SCHEMA_TRIPLE_LOG : 0));
+        },
+        // set the current value, so that the next one is nextNodeId + 1 on
+        // every server version (RESTART WITH differs from Firebird 4 on)
+        [&db, nextNodeId] (DbTransaction &tr) {
+            DbStatement st = db.createStatement(
+                    "SELECT GEN_ID(SEQ_NODE, ? - GEN_ID(SEQ_NODE, 0)) "
+                    "FROM RDB$DATABASE", &tr);
+            st.setInt(1, nextNodeId);
+            st.uniqueResult();
+        }
+    };
+
+    for (size_t i = (size_t) firstStep; i < steps.size(); ++i) {
+        DbTransaction tr{db.nativeHandle(), 1};
+        steps[i](tr);
+        DbStatement st = db.createStatement(
+                                "UPDATE UNIFIED_MIGRATION SET STEP=?", &tr);
+        st.setInt(1, (int64_t) i + 1);
+        st.execute();
+        tr.commit();
+    }
+
+    execute_ddl(db, { "DROP TABLE UNIFIED_MIGRATION" });
+}
+
+void compact_triple_count(DbConnection &db, DbTransaction &tr)
+{
+    // the rows summed are the rows deleted through the cursor, changes
+    // committed meanwhile by others are left for the next compaction; a
+    // context's row is kept when its count drops to 0 to keep LAST_MODIFIED
+    db.executeUpdate(R"(EXECUTE BLOCK AS
+DECLARE C BIGINT;
+DECLARE D BIGINT;
+DECLARE N BIGINT;
+DECLARE T TIMESTAMP;
+DECLARE M TIMESTAMP;
+BEGIN
+    FOR SELECT C_URI FROM TRIPLE_COUNT
+        GROUP BY C_URI HAVING COUNT(*) > 1 INTO :C DO
+    BEGIN
+        N = 0;
+        M = NULL;
+        FOR SELECT DELTA, LAST_MODIFIED FROM TRIPLE_COUNT
+            WHERE C_URI IS NOT DISTINCT FROM :C INTO :D, :T AS CURSOR CUR DO
+        BEGIN
+            N = N + D;
+            IF (M IS NULL OR T > M) THEN
+                M = T;
+            DELETE FROM TRIPLE_COUNT WHERE CURRENT OF CUR;
+        END
+        INSERT INTO TRIPLE_COUNT (C_URI, DELTA, LAST_MODIFIED)
+        VALUES (:C, :N, :M);
+    END
+END)", &tr);
+}
+
 void update_index_statistics(const char *dbName, const char *server,
                              const char *userName, const char *userPassword)
 {
@@ -340,4 +1219,142 @@ void update_index_statistics(const char *dbName, const char *server,
     }
 }
 
+void update_index_statistics(const char *dbName, const char *server,
+                             const char *userName, const char *userPassword,
+                             const std::vector<std::string> &tables)
+{
+    DbConnection db{dbName, server, userName, userPassword};
+    DbTransaction tr{db.nativeHandle(), 1};
+
+    const char *sql = "SELECT RDB$INDEX_NAME "
+                      "FROM RDB$INDICES "
+                      "WHERE RDB$SYSTEM_FLAG=0 AND RDB$RELATION_NAME=?";
+
+    DbStatement st = db.createStatement(sql, &tr);
+    string q;
+    for (const string &table : tables) {
+        st.reset();
+        st.setText(1, table.c_str());
+        for (DbStatement::Iterator i = st.iterate(); i != st.end(); ++i) {
+            q = "SET STATISTICS INDEX ";
+            q += (*i).getText(0);
+            db.executeUpdate(q.c_str(), &tr);
+        }
+    }
+}
+
+/** return the names of the TRIPLE indexes which are (in)active */
+static std::vector<string> get_triple_indexes(DbConnection &db, bool inactive)
+{
+    DbTransaction tr{db.nativeHandle(), 1};
+    DbStatement st = db.createStatement(
+                        "SELECT RDB$INDEX_NAME FROM RDB$INDICES "
+                        "WHERE RDB$RELATION_NAME='TRIPLE' "
+                        "AND RDB$SYSTEM_FLAG=0 "
+                        "AND COALESCE(RDB$INDEX_INACTIVE, 0)=? "
+                        "AND RDB$INDEX_NAME NOT IN "
+                        "(SELECT RDB$INDEX_NAME FROM RDB$RELATION_CONSTRAINTS "
+                        "WHERE RDB$INDEX_NAME IS NOT NULL)", &tr);
+    st.setInt(1, inactive ? 1 : 0);
+
+    std::vector<string> names;
+    for (DbStatement::Iterator i = st.iterate(); i != st.end(); ++i) {
+        string name = (*i).getText(0);
+        name.erase(name.find_last_not_of(' ') + 1);
+        names.push_back(name);
+    }
+    return names;
+}
+
+void deactivate_triple_indexes(const char *dbName, const char *server,
+                               const char *userName, const char *userPassword)
+{
+    DbConnection db{dbName, server, userName, userPassword};
+    for (const string &name : get_triple_indexes(db, false)) {
+        string q = "ALTER INDEX " + name + " INACTIVE";
+        execute_ddl(db, {q.c_str()});
+    }
+}
+
+int64_t register_fast_load(DbConnection &db, DbTransaction &tr)
+{
+    create_missing_table(db, "FASTLOAD_STATE");
+    db.executeUpdate("UPDATE OR INSERT INTO FASTLOAD_STATE "
+                     "(ATTACHMENT_ID, STARTED) "
+                     "VALUES (CURRENT_CONNECTION, CURRENT_TIMESTAMP)", &tr);
+    DbStatement st = db.createStatement(
+                    "SELECT CURRENT_CONNECTION FROM RDB$DATABASE", &tr);
+    return st.uniqueResult().getInt64(0);
+}
+
+/** the number of fast load markers, of live attachments if alive */
+static int64_t count_fast_loads(DbConnection &db, DbTransaction &tr,
+                                bool alive)
+{
+    DbStatement st = db.createStatement(alive ?
+            "SELECT COUNT(*) FROM FASTLOAD_STATE f WHERE EXISTS "
+            "(SELECT 1 FROM MON$ATTACHMENTS a "
+            "WHERE a.MON$ATTACHMENT_ID = f.ATTACHMENT_ID)" :
+            "SELECT COUNT(*) FROM FASTLOAD_STATE", &tr);
+    return st.uniqueResult().getInt64(0);
+}
+
+bool fast_load_interrupted(DbConnection &db, DbTransaction &tr)
+{
+    DbStatement st = db.createStatement(
+                            "SELECT RDB$DB_KEY FROM RDB$RELATIONS "
+                            "WHERE RDB$RELATION_NAME='FASTLOAD_STATE'", &tr);
+    if (!st.uniqueResult()) {
+        return false;
+    }
+    // the indexes are only reactivated once no fast load is running
+    return count_fast_loads(db, tr, false) != 0 &&
+           count_fast_loads(db, tr, true) == 0;
+}
+
+unsigned int end_fast_load(const char *dbName, const char *server,
+                           const char *userName, const char *userPassword,
+                           int64_t attachmentId)
+{
+    {
+        DbConnection db{dbName, server, userName, userPassword};
+        DbTransaction tr{db.nativeHandle(), 1};
+        // the markers of this and of ended attachments
+        DbStatement st = db.createStatement(
+                "DELETE FROM FASTLOAD_STATE f WHERE f.ATTACHMENT_ID = ? "
+                "OR NOT EXISTS (SELECT 1 FROM MON$ATTACHMENTS a "
+                "WHERE a.MON$ATTACHMENT_ID = f.ATTACHMENT_ID)", &tr);
+        st.setInt(1, attachmentId);
+        st.execute();
+        const bool othersLoading = count_fast_loads(db, tr, false) != 0;
+        tr.commit();
+        if (othersLoading) {
+            return 0;
+        }
+    }
+    return activate_triple_indexes(dbName, server, userName, userPassword);
+}
+
+unsigned int activate_triple_indexes(const char *dbName, const char *server,
+                                     const char *userName,
+                                     const char *userPassword)
+{
+    std::vector<string> names;
+    {
+        DbConnection db{dbName, server, userName, userPassword};
+        names = get_triple_indexes(db, true);
+        for (const string &name : names) {
+            // rebuilds the index in one pass
+            string q = "ALTER INDEX " + name + " ACTIVE";
+            execute_ddl(db, {q.c_str()});
+        }
+    }
+
+    if (!names.empty()) {
+        update_index_statistics(dbName, server, userName, userPassword,
+                                {"TRIPLE"});
+    }
+    return (unsigned int) names.size();
+}
+
 } /* namespace rdf */
@@ -14,19 +14,158 @@
 #ifndef RDFDBSCHEMABUILDER_H_
 #define RDFDBSCHEMABUILDER_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// forward declarations
+namespace fb {
+class DbConnection;
+class DbTransaction;
+}
+
 namespace rdf
 {
 
+/** optional database schema features, passed to create_firebird_rdf_db */
+enum SchemaFlags : unsigned int
+{
+    SCHEMA_DEFAULT = 0x0,
+    /** (S,P,O,C), (P,O,S), (O,S,P) and (C,S,P,O) indexes on TRIPLE */
+    SCHEMA_COMPOSITE_INDEXES = 0x1,
+    /**
+     * TRIPLE stores subjects and objects in single S_ID/O_ID columns, the
+     * IDs of all nodes come from the SEQ_NODE sequence and the S_KIND/O_KIND
+     * columns tell which node table they refer to (see NodeKind)
+     */
+    SCHEMA_UNIFIED_NODES = 0x2,
+    /**
+     * RESOURCE.URI_HASH and LITERAL.VAL_HASH columns with non-unique
+     * indexes, node lookups search these narrow keys (see node_hash())
+     */
+    SCHEMA_HASH_LOOKUP = 0x4,
+    /**
+     * literals too long for LITERAL.VAL are stored in the LITERAL.VAL_BLOB
+     * text BLOB and found through their VAL_HASH, requires SCHEMA_HASH_LOOKUP
+     */
+    SCHEMA_LONG_LITERALS = 0x8,
+    /**
+     * TRIPLE triggers record +1/-1 rows per context in TRIPLE_COUNT, which
+     * compact_triple_count() folds into one row per context; the
+     * CONTEXT_STATS view sums them up with the last modification time
+     */
+    SCHEMA_TRIPLE_COUNT = 0x10,
+    /**
+     * TRIPLE triggers append each added (OP 1) and removed (OP -1) statement
+     * to TRIPLE_LOG, numbered by the SEQ_TRIPLE_LOG sequence, the nodes in
+     * the S_KIND/S_ID, O_KIND/O_ID form of SCHEMA_UNIFIED_NODES
+     */
+    SCHEMA_TRIPLE_LOG = 0x20
+};
+
+/** longest literal value (in bytes) stored inline in LITERAL.VAL */
+constexpr size_t INLINE_LITERAL_LENGTH = 1250;
+
+/** longest literal value (in bytes) which can be stored in LITERAL.VAL_BLOB */
+constexpr size_t LONG_LITERAL_LENGTH = 32765;
+
+/** values of the TRIPLE.S_KIND and TRIPLE.O_KIND columns */
+enum NodeKind : int
+{
+    NODE_KIND_RESOURCE = 1,
+    NODE_KIND_BLANK = 2,
+    NODE_KIND_LITERAL = 3
+};
+
 void create_firebird_rdf_db(const char *dbName,
                             const char *server = nullptr,
                             const char *userName = nullptr,
-                            const char *userPassword = nullptr);
+                            const char *userPassword = nullptr,
+                            unsigned int schemaFlags = SCHEMA_DEFAULT);
+
+/**
+ * create the table name of the schema if it doesn't exist, for bookkeeping
+ * tables added after databases were created with new='yes'
+ */
+void create_missing_table(fb::DbConnection &db, const char *name);
+
+/** detect which SchemaFlags features an existing database has */
+unsigned int get_schema_flags(fb::DbConnection &db, fb::DbTransaction &tr);
+
+/**
+ * Convert the TRIPLE table of an existing database to the
+ * SCHEMA_UNIFIED_NODES layout. Blank node and literal IDs are renumbered.
+ * The database must not be in use while migrating. The progress is kept in
+ * the UNIFIED_MIGRATION table, calling this again resumes an interrupted
+ * migration and get_schema_flags() refuses such a database meanwhile.
+ */
+void migrate_to_unified_schema(const char *dbName,
+                               const char *server = nullptr,
+                               const char *userName = nullptr,
+                               const char *userPassword = nullptr);
+
+/**
+ * fold the TRIPLE_COUNT rows of each context into a single row, keeps
+ * summing the table cheap (SCHEMA_TRIPLE_COUNT)
+ */
+void compact_triple_count(fb::DbConnection &db, fb::DbTransaction &tr);
 
 void update_index_statistics(const char *dbName,
                              const char *server = nullptr,
                              const char *userName = nullptr,
                              const char *userPassword = nullptr);
 
+/** recompute the selectivity of the indexes of the given tables only */
+void update_index_statistics(const char *dbName,
+                             const char *server,
+                             const char *userName,
+                             const char *userPassword,
+                             const std::vector<std::string> &tables);
+
+/**
+ * deactivate the TRIPLE indexes which don't enforce a constraint, for fast
+ * loads; activate_triple_indexes() turns them on again
+ */
+void deactivate_triple_indexes(const char *dbName,
+                               const char *server = nullptr,
+                               const char *userName = nullptr,
+                               const char *userPassword = nullptr);
+
+/**
+ * record the fast load of the connection in FASTLOAD_STATE (created if
+ * missing), return its attachment ID; the caller commits
+ */
+int64_t register_fast_load(fb::DbConnection &db, fb::DbTransaction &tr);
+
+/**
+ * whether fast loads left the TRIPLE indexes inactive: there are
+ * FASTLOAD_STATE markers, but none of a live attachment (which needs the
+ * rights to see other users' attachments in MON$ATTACHMENTS, as the owner
+ * who may alter the indexes has)
+ */
+bool fast_load_interrupted(fb::DbConnection &db, fb::DbTransaction &tr);
+
+/**
+ * remove the fast load marker of attachmentId (0 for none) and those of
+ * ended attachments, then activate the TRIPLE indexes unless another fast
+ * load is running; return the number of activated indexes
+ */
+unsigned int end_fast_load(const char *dbName,
+                           const char *server,
+                           const char *userName,
+                           const char *userPassword,
+                           int64_t attachmentId);
+
+/**
+ * activate (and so rebuild) the inactive TRIPLE indexes and recompute their
+ * selectivity, return the number of activated indexes
+ */
+unsigned int activate_triple_indexes(const char *dbName,
+                                     const char *server = nullptr,
+                                     const char *userName = nullptr,
+                                     const char *userPassword = nullptr);
+
 } /* namespace rdf */
 
 #endif /* RDFDBSCHEMABUILDER_H_ */
@@ -0,0 +1,88 @@
+/*
+ * ZipfGenerator.h - reproducible random data for the benchmarks
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#ifndef ZIPFGENERATOR_H_
+#define ZIPFGENERATOR_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace bench
+{
+
+/** splitmix64, the same sequence on every platform for a given seed */
+class Random final
+{
+public:
+    explicit Random(uint64_t seed) : state_(seed)
+    {
+    }
+
+    uint64_t next()
+    {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /** uniform in [0, 1) */
+    double uniform()
+    {
+        return (double) (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /** uniform in [0, n) */
+    unsigned int below(unsigned int n)
+    {
+        return (unsigned int) (uniform() * n);
+    }
+
+private:
+    uint64_t state_;
+};
+
+/** integers in [0, n) where rank k is drawn with probability ~ 1/(k+1)^s */
+class ZipfGenerator final
+{
+public:
+    ZipfGenerator(unsigned int n, double s) : cdf_(n ? n : 1)
+    {
+        double sum = 0;
+        for (size_t k = 0; k != cdf_.size(); ++k) {
+            sum += 1.0 / std::pow((double) (k + 1), s);
+            cdf_[k] = sum;
+        }
+        for (double &c : cdf_) {
+            c /= sum;
+        }
+    }
+
+    unsigned int operator()(Random &r) const
+    {
+        const size_t k = std::lower_bound(cdf_.begin(), cdf_.end(),
+                                          r.uniform()) - cdf_.begin();
+        return (unsigned int) std::min(k, cdf_.size() - 1);
+    }
+
+private:
+    std::vector<double> cdf_;
+};
+
+} /* namespace bench */
+
+#endif /* ZIPFGENERATOR_H_ */
@@ -0,0 +1,347 @@
+/*
+ * cache_benchmark.cpp - microbenchmarks of the node caches
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "GenericCache.h"
+#include "Metrics.h"
+#include "NodeHash.h"
+#include "ZipfGenerator.h"
+
+
+using namespace std;
+
+namespace {
+
+// bytes allocated with operator new and not yet freed
+size_t liveBytes = 0;
+
+// the size is kept in front of each block, aligned for any type
+const size_t HEADER_SIZE = 16;
+
+volatile int64_t benchmarkSink;
+
+} // namespace
+
+// not inlined, so that the compiler doesn't pair the library's deallocations
+// with malloc and free
+__attribute__((noinline)) void *operator new(size_t size)
+{
+    char *block = (char*) malloc(size + HEADER_SIZE);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *(size_t*) block = size;
+    liveBytes += size;
+    return block + HEADER_SIZE;
+}
+
+__attribute__((noinline)) void operator delete(void *ptr) noexcept
+{
+    if (ptr) {
+        char *block = (char*) ptr - HEADER_SIZE;
+        liveBytes -= *(size_t*) block;
+        free(block);
+    }
+}
+
+namespace {
+
+/** stands in for the database lookup of a node ID */
+struct LookupId
+{
+    int64_t operator()(const string &key) const
+    {
+        // never 0, the value GenericCache takes for "not found"
+        return rdf::node_hash(key.data(), key.size()) | 1;
+    }
+};
+
+/** a key set and the order its keys are looked up in */
+struct Workload
+{
+    string name;
+    const vector<string> *keys;
+    vector<uint32_t> accesses;
+};
+
+/** the measurements of a cache backend on a workload */
+struct Result
+{
+    string name;
+    uint64_t operations = 0;
+    double nsPerOp = 0;
+    double hitRate = 0;
+    double bytesPerEntry = 0;
+    size_t entries = 0;
+    metrics::LatencyHistogram latency;
+    // lookups which trimmed the cache
+    metrics::LatencyHistogram trims;
+};
+
+typedef chrono::steady_clock Clock;
+
+static uint64_t elapsed_ns(Clock::time_point start)
+{
+    return (uint64_t) chrono::duration_cast<chrono::nanoseconds>(
+                                        Clock::now() - start).count();
+}
+
+/**
+ * URIs shaped like those of real data sets: a few long shared namespaces
+ * followed by names or numbers.
+ */
+static vector<string> make_uris(unsigned int count, uint64_t seed)
+{
+    static const char *const namespaces[] = {
+        "http://dbpedia.org/resource/",
+        "http://www.wikidata.org/entity/Q",
+        "http://xmlns.com/foaf/0.1/",
+        "http://purl.org/dc/terms/",
+        "http://www.w3.org/1999/02/22-rdf-syntax-ns#",
+        "http://example.org/data/2015/item-"
+    };
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz_";
+
+    bench::Random r(seed);
+    vector<string> uris;
+    uris.reserve(count);
+    for (unsigned int i = 0; i != count; ++i) {
+        const unsigned int ns = r.below(sizeof(namespaces) / sizeof(*namespaces));
+        string uri = namespaces[ns];
+        if (ns == 1 || ns == 5) {
+            uri += to_string(i);
+        } else {
+            const unsigned int len = 4 + r.below(20);
+            for (unsigned int k = 0; k != len; ++k) {
+                uri += letters[r.below(sizeof(letters) - 1)];
+            }
+            uri += '_';
+            uri += to_string(i);
+        }
+        uris.push_back(move(uri));
+    }
+    return uris;
+}
+
+/** zipf < 0 makes a cyclic scan over all keys, the worst case for LRU */
+static Workload make_workload(const string &name, const vector<string> &keys,
+                              double zipf, unsigned int length, uint64_t seed)
+{
+    Workload w{name, &keys, {}};
+    w.accesses.reserve(length);
+    bench::Random r(seed);
+    const bench::ZipfGenerator gen((unsigned int) keys.size(),
+                                   zipf > 0 ? zipf : 0);
+    for (unsigned int i = 0; i != length; ++i) {
+        w.accesses.push_back(zipf < 0 ? i % (uint32_t) keys.size() :
+                             zipf == 0 ? r.below((unsigned int) keys.size()) :
+                             gen(r));
+    }
+    return w;
+}
+
+/**
+ * Measure a cache type constructed from a LookupId: ns/op over at least
+ * minSeconds, the hit rate and memory once warmed up and the latency of
+ * single lookups, separately for those that trimmed the cache.
+ */
+template <class Cache>
+static Result run_backend(const string &backend, const Workload &w,
+                          double minSeconds)
+{
+    Result res;
+    res.name = backend + "/" + w.name;
+    const size_t bytesBefore = liveBytes;
+    unique_ptr<Cache> cache(new Cache(LookupId()));
+
+    // warm up with one pass
+    for (uint32_t k : w.accesses) {
+        cache->getValue((*w.keys)[k]);
+    }
+    res.entries = cache->size();
+    res.bytesPerEntry = res.entries ?
+            (double) (liveBytes - bytesBefore) / (double) res.entries : 0;
+
+    const uint64_t hits = cache->hits();
+    const uint64_t misses = cache->misses();
+    int64_t sink = 0;
+    const Clock::time_point begin = Clock::now();
+    uint64_t ns = 0;
+    do {
+        for (uint32_t k : w.accesses) {
+            sink += cache->getValue((*w.keys)[k]);
+        }
+        res.operations += w.accesses.size();
+        ns = elapsed_ns(begin);
+    } while (ns < minSeconds * 1e9);
+    res.nsPerOp = (double) ns / (double) res.operations;
+
+    const uint64_t lookups = (cache->hits() - hits) +
+                             (cache->misses() - misses);
+    res.hitRate = lookups ? (double) (cache->hits() - hits) / lookups : 0;
+
+    for (uint32_t k : w.accesses) {
+        const uint64_t evictions = cache->evictions();
+        const Clock::time_point start = Clock::now();
+        sink += cache->getValue((*w.keys)[k]);
+        const uint64_t t = elapsed_ns(start);
+        res.latency.record(t);
+        if (cache->evictions() != evictions) {
+            res.trims.record(t);
+        }
+    }
+
+    // keep the lookups from being optimized away
+    benchmarkSink = sink;
+    return res;
+}
+
+static void print_header()
+{
+    printf("%-44s %9s %8s %11s %8s %8s %9s %10s %7s %11s\n",
+           "Benchmark", "ns/op", "hit_rate", "bytes/entry", "entries",
+           "p50_ns", "p99_ns", "max_ns", "trims", "trim_p99_ns");
+}
+
+static void print_result(const Result &r)
+{
+    printf("%-44s %9.1f %8.4f %11.1f %8zu %8llu %9llu %10llu %7llu %11llu\n",
+           r.name.c_str(), r.nsPerOp, r.hitRate, r.bytesPerEntry, r.entries,
+           (unsigned long long) r.latency.percentile(0.5),
+           (unsigned long long) r.latency.percentile(0.99),
+           (unsigned long long) r.latency.max(),
+           (unsigned long long) r.trims.count(),
+           (unsigned long long) r.trims.percentile(0.99));
+    fflush(stdout);
+}
+
+static void write_json(ostream &os, const vector<Result> &results)
+{
+    os << "{\n  \"benchmarks\": [";
+    for (size_t i = 0; i != results.size(); ++i) {
+        const Result &r = results[i];
+        os << (i ? "," : "") << "\n    {"
+           << "\"name\": \"" << r.name << "\""
+           << ", \"iterations\": " << r.operations
+           << ", \"ns_per_op\": " << r.nsPerOp
+           << ", \"hit_rate\": " << r.hitRate
+           << ", \"bytes_per_entry\": " << r.bytesPerEntry
+           << ", \"entries\": " << r.entries
+           << ", \"p50_ns\": " << r.latency.percentile(0.5)
+           << ", \"p99_ns\": " << r.latency.percentile(0.99)
+           << ", \"p999_ns\": " << r.latency.percentile(0.999)
+           << ", \"max_ns\": " << r.latency.max()
+           << ", \"trims\": " << r.trims.count()
+           << ", \"trim_p50_ns\": " << r.trims.percentile(0.5)
+           << ", \"trim_max_ns\": " << r.trims.max()
+           << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+static int usage(char *argv[])
+{
+    cout << "Synopsys:\n"
+         << "    " << argv[0] << " [-filter <text>] [-min_time <seconds>] "
+            "[-json <file>]\n"
+         << "\n"
+         << "    -filter    only run the benchmarks whose name contains text\n"
+         << "    -min_time  time each benchmark for at least this long (0.5)\n"
+         << "    -json      also write the results as JSON to file\n";
+    return 1;
+}
+
+// the cache the storage uses for resources and one trimmed less often
+typedef cache::GenericCache<string, int64_t, LookupId> ResourceCache;
+typedef cache::GenericCache<string, int64_t, LookupId, 0, 4096> LargeCache;
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    string filter;
+    string jsonFile;
+    double minSeconds = 0.5;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-filter") == 0 && (i + 1) < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "-min_time") == 0 && (i + 1) < argc) {
+            minSeconds = strtod(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "-json") == 0 && (i + 1) < argc) {
+            jsonFile = argv[++i];
+        } else {
+            return usage(argv);
+        }
+    }
+
+    // vocabulary: predicates and classes, all fit in the cache
+    const vector<string> vocabulary = make_uris(300, 1);
+    // entities: subjects and objects of a mid sized and a large data set
+    const vector<string> entities = make_uris(20000, 2);
+    const vector<string> manyEntities = make_uris(500000, 3);
+
+    const unsigned int length = 1 << 18;
+    vector<Workload> workloads;
+    workloads.push_back(make_workload("vocabulary/zipf_1.0", vocabulary,
+                                      1.0, length, 11));
+    workloads.push_back(make_workload("entities/uniform", entities,
+                                      0, length, 12));
+    workloads.push_back(make_workload("entities/zipf_0.8", entities,
+                                      0.8, length, 13));
+    workloads.push_back(make_workload("entities/zipf_1.2", entities,
+                                      1.2, length, 14));
+    workloads.push_back(make_workload("entities/scan", entities,
+                                      -1, length, 15));
+    workloads.push_back(make_workload("many_entities/zipf_1.0", manyEntities,
+                                      1.0, length, 16));
+
+    vector<Result> results;
+    print_header();
+    for (const Workload &w : workloads) {
+        // new cache backends are added here
+        if (filter.empty() ||
+                ("GenericCache<512>/" + w.name).find(filter) != string::npos) {
+            results.push_back(run_backend<ResourceCache>("GenericCache<512>",
+                                                         w, minSeconds));
+            print_result(results.back());
+        }
+        if (filter.empty() ||
+                ("GenericCache<4096>/" + w.name).find(filter) != string::npos) {
+            results.push_back(run_backend<LargeCache>("GenericCache<4096>",
+                                                      w, minSeconds));
+            print_result(results.back());
+        }
+    }
+
+    if (!jsonFile.empty()) {
+        ofstream ofs(jsonFile.c_str());
+        write_json(ofs, results);
+        if (!ofs) {
+            cerr << "Failed to write " << jsonFile << "\n";
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,429 @@
+/*
+ * ntriples_reader_test.cpp - tests of the N-Triples reader and the
+ * decompression of its input, no database needed
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#ifdef RDF_FIREBIRD_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "Decompressor.h"
+#include "NTriplesReader.h"
+
+
+using namespace std;
+using rdf::NodeKind;
+using rdf::NodeQuad;
+using rdf::NodeTerm;
+using rdf::NTriplesReader;
+
+/** a NodeTerm with its strings copied */
+struct Term
+{
+    NodeKind kind;
+    string value;
+    string lang;
+    string datatype;
+};
+
+/** a NodeQuad with its strings copied, graph is empty without a graph */
+struct Quad
+{
+    Term s;
+    Term p;
+    Term o;
+    string graph;
+};
+
+static Term copy_term(const NodeTerm &t)
+{
+    return Term{t.kind, t.value, t.lang ? t.lang : "",
+                t.datatype ? t.datatype : ""};
+}
+
+/** a temporary file removed when it goes out of scope */
+class TempFile
+{
+public:
+    explicit TempFile(const char *suffix)
+            : name_(string("/tmp/ntriples_reader_test_XXXXXX") + suffix)
+    {
+        const int fd = mkstemps(&name_[0], (int) strlen(suffix));
+        if (fd < 0) {
+            throw runtime_error("Cannot create a temporary file");
+        }
+        close(fd);
+    }
+
+    ~TempFile()
+    {
+        unlink(name_.c_str());
+    }
+
+    TempFile(const TempFile&) = delete;
+    TempFile &operator=(const TempFile&) = delete;
+
+    const char *name() const
+    {
+        return name_.c_str();
+    }
+
+    void write(const string &text) const
+    {
+        FILE *f = fopen(name_.c_str(), "wb");
+        if (!f || fwrite(text.data(), 1, text.size(), f) != text.size()) {
+            throw runtime_error("Cannot write " + name_);
+        }
+        fclose(f);
+    }
+
+private:
+    string name_;
+};
+
+/** read all statements of a file, in small batches */
+static vector<Quad> read_all(const char *fileName,
+                             const string &blankPrefix = "")
+{
+    NTriplesReader reader(fileName, blankPrefix);
+    vector<Quad> result;
+    vector<NodeQuad> quads;
+    while (reader.read(quads, 7)) {
+        for (const NodeQuad &q : quads) {
+            result.push_back(Quad{copy_term(q.subject),
+                                  copy_term(q.predicate),
+                                  copy_term(q.object),
+                                  q.graph ? q.graph : ""});
+        }
+    }
+    return result;
+}
+
+static vector<Quad> read_text(const string &text,
+                              const string &blankPrefix = "")
+{
+    TempFile file(".nt");
+    file.write(text);
+    return read_all(file.name(), blankPrefix);
+}
+
+/** the message of the error reading text, empty if it was read */
+static string read_error(const string &text)
+{
+    try {
+        read_text(text);
+    } catch (std::exception &e) {
+        return e.what();
+    }
+    return string();
+}
+
+static bool check(bool ok, const string &what)
+{
+    if (!ok) {
+        cerr << "failed: " << what << "\n";
+    }
+    return ok;
+}
+
+static bool check_value(const string &actual, const string &expected,
+                        const string &what)
+{
+    return check(actual == expected, what + ": got '" + actual +
+                                     "', expected '" + expected + "'");
+}
+
+/** single character, \u and \U escapes in literals and IRIs */
+static bool test_escapes()
+{
+    const vector<Quad> q = read_text(
+            "<http://ex.org/s> <http://ex.org/p> \"a\\tb\\n\\\"q\\\"\\\\\" .\n"
+            "<http://ex.org/s> <http://ex.org/p> \"\\u00E9\\U0001F600\" .\n"
+            "<http://ex.org/\\u0041> <http://ex.org/p> \"x\"@en-GB .\n"
+            "<http://ex.org/s> <http://ex.org/p> "
+            "\"1\"^^<http://www.w3.org/2001/XMLSchema#int> .\n");
+    bool ok = check(q.size() == 4, "4 statements");
+    if (!ok) {
+        return false;
+    }
+    ok &= check_value(q[0].o.value, "a\tb\n\"q\"\\", "single escapes");
+    ok &= check_value(q[1].o.value, "\xC3\xA9\xF0\x9F\x98\x80",
+                      "\\u and \\U escapes");
+    ok &= check_value(q[2].s.value, "http://ex.org/A", "escape in an IRI");
+    ok &= check_value(q[2].o.lang, "en-GB", "language tag");
+    ok &= check_value(q[3].o.datatype,
+                      "http://www.w3.org/2001/XMLSchema#int", "datatype");
+    ok &= check(!read_error("<http://ex.org/\\n> <http://ex.org/p> "
+                            "<http://ex.org/o> .\n").empty(),
+                "single character escape in an IRI is rejected");
+    ok &= check(!read_error("<http://ex.org/s> <http://ex.org/p> "
+                            "\"\\U00110000\" .\n").empty(),
+                "code point above U+10FFFF is rejected");
+    return ok;
+}
+
+/** a quote preceded by an even number of backslashes closes the literal */
+static bool test_closing_quote()
+{
+    const vector<Quad> q = read_text(
+            "<http://ex.org/s> <http://ex.org/p> \"x\\\\\"@en .\n"
+            "<http://ex.org/s> <http://ex.org/p> \"a\\\\\\\"b\" .\n");
+    bool ok = check(q.size() == 2, "2 statements");
+    if (!ok) {
+        return false;
+    }
+    ok &= check_value(q[0].o.value, "x\\", "escaped final backslash");
+    ok &= check_value(q[0].o.lang, "en", "language after the backslash");
+    ok &= check_value(q[1].o.value, "a\\\"b", "escaped quote");
+    return ok;
+}
+
+/** blank node labels get the prefix and lose the final '.' */
+static bool test_blank_labels()
+{
+    const vector<Quad> q = read_text(
+            "_:a <http://ex.org/p> _:b1.\n"
+            "_:a.b <http://ex.org/p> _:c . # comment\n", "load1_");
+    bool ok = check(q.size() == 2, "2 statements");
+    if (!ok) {
+        return false;
+    }
+    ok &= check(q[0].s.kind == rdf::NODE_KIND_BLANK, "blank subject");
+    ok &= check_value(q[0].s.value, "load1_a", "prefixed label");
+    ok &= check_value(q[0].o.value, "load1_b1", "label before '.'");
+    ok &= check_value(q[1].s.value, "load1_a.b", "'.' inside a label");
+    ok &= check_value(q[1].o.value, "load1_c", "label before ' .'");
+    return ok;
+}
+
+/** a byte order mark, CRLF line ends, comments and empty lines */
+static bool test_bom_and_crlf()
+{
+    const vector<Quad> q = read_text(
+            "\xEF\xBB\xBF<http://ex.org/s> <http://ex.org/p> "
+            "<http://ex.org/o> .\r\n"
+            "# comment\r\n"
+            "\r\n"
+            "  \t\r\n"
+            "<http://ex.org/s> <http://ex.org/p> \"v\" .\r\n"
+            "<http://ex.org/s> <http://ex.org/p> \"last\" .");
+    bool ok = check(q.size() == 3, "3 statements");
+    if (!ok) {
+        return false;
+    }
+    ok &= check_value(q[0].s.value, "http://ex.org/s", "subject after BOM");
+    ok &= check_value(q[1].o.value, "v", "literal before CRLF");
+    ok &= check_value(q[2].o.value, "last", "line without a line end");
+    return ok;
+}
+
+/** the graph term of N-Quads */
+static bool test_nquads_graph()
+{
+    const vector<Quad> q = read_text(
+            "<http://ex.org/s> <http://ex.org/p> <http://ex.org/o> "
+            "<http://ex.org/g> .\n"
+            "<http://ex.org/s> <http://ex.org/p> \"v\"@en <http://ex.org/h>.\n"
+            "<http://ex.org/s> <http://ex.org/p> <http://ex.org/o> .\n");
+    bool ok = check(q.size() == 3, "3 statements");
+    if (!ok) {
+        return false;
+    }
+    ok &= check_value(q[0].graph, "http://ex.org/g", "graph");
+    ok &= check_value(q[1].graph, "http://ex.org/h", "graph after literal");
+    ok &= check_value(q[2].graph, "", "default graph");
+    ok &= check(!read_error("<http://ex.org/s> <http://ex.org/p> "
+                            "<http://ex.org/o> _:g .\n").empty(),
+                "blank node graph is rejected");
+    return ok;
+}
+
+/** syntax errors name the line, counting comments and empty lines */
+static bool test_error_lines()
+{
+    bool ok = check_value(read_error("<http://ex.org/s> <http://ex.org/p> "
+                                     "<http://ex.org/o> .\n"
+                                     "# comment\n"
+                                     "\n"
+                                     "<http://ex.org/s> <http://ex.org/p> .\n"),
+                          "line 4: expected an IRI, a blank node or a literal",
+                          "missing object");
+    ok &= check_value(read_error("<http://ex.org/s> <http://ex.org/p> "
+                                 "\"open .\n"),
+                      "line 1: unterminated literal", "unterminated literal");
+    ok &= check_value(read_error("\"s\" <http://ex.org/p> <http://ex.org/o> .\n"),
+                      "line 1: literal subject", "literal subject");
+    ok &= check_value(read_error("\r\n<http://ex.org/s> <http://ex.org/p> "
+                                 "<http://ex.org/o>\r\n"),
+                      "line 2: expected '.'", "missing '.'");
+    ok &= check_value(read_error("<http://ex.org/s> <http://ex.org/p> "
+                                 "<http://ex.org/o> . x\n"),
+                      "line 1: unexpected text after '.'", "text after '.'");
+    return ok;
+}
+
+#ifdef RDF_FIREBIRD_HAVE_ZLIB
+/** lines first to first + count - 1 of a generated N-Triples text */
+static string numbered_lines(unsigned int first, unsigned int count)
+{
+    string text;
+    for (unsigned int i = first; i != first + count; ++i) {
+        text += "<http://ex.org/s" + to_string(i) + "> <http://ex.org/p> \"v" +
+                to_string(i) + "\" .\n";
+    }
+    return text;
+}
+
+/** append text to a gzip file as a gzip member of its own */
+static void append_gzip_member(const char *fileName, const string &text)
+{
+    gzFile gz = gzopen(fileName, "ab");
+    if (!gz || gzwrite(gz, text.data(), (unsigned int) text.size()) !=
+               (int) text.size()) {
+        throw runtime_error(string("Cannot write ") + fileName);
+    }
+    gzclose(gz);
+}
+
+/** whether quads are the numbered_lines() first, first + 1... */
+static bool check_numbered(const vector<Quad> &q, unsigned int first,
+                           unsigned int count)
+{
+    if (!check(q.size() == count, to_string(count) + " statements, got " +
+                                  to_string(q.size()))) {
+        return false;
+    }
+    for (unsigned int i = 0; i != count; ++i) {
+        const string n = to_string(first + i);
+        if (!check_value(q[i].s.value, "http://ex.org/s" + n, "subject") ||
+            !check_value(q[i].o.value, "v" + n, "object")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** the members of a multi-member gzip file are read one after the other */
+static bool test_gzip_members()
+{
+    TempFile file(".nt.gz");
+    file.write("");
+    append_gzip_member(file.name(), numbered_lines(0, 100));
+    append_gzip_member(file.name(), numbered_lines(100, 50));
+    append_gzip_member(file.name(), numbered_lines(150, 1));
+    return check_numbered(read_all(file.name()), 0, 151);
+}
+
+/** lines which span the chunks handed over by the Decompressor */
+static bool test_gzip_chunk_boundaries()
+{
+    // several chunks; the line lengths vary, so lines cross the boundaries
+    unsigned int count = 0;
+    string text;
+    while (text.size() < 3 * rdf::Decompressor::CHUNK_SIZE + 100) {
+        text += numbered_lines(count++, 1);
+    }
+    TempFile file(".nt.gz");
+    file.write("");
+    append_gzip_member(file.name(), text);
+
+    rdf::Decompressor d(file.name(), rdf::COMPRESSION_GZIP);
+    string chunk;
+    string all;
+    unsigned int chunks = 0;
+    while (d.next(chunk)) {
+        all += chunk;
+        chunks++;
+    }
+    bool ok = check(all == text, "decompressed data equals the input");
+    ok &= check(chunks >= 4, "the data spans several chunks");
+    return ok && check_numbered(read_all(file.name()), 0, count);
+}
+
+/** a gzip file cut short is an error, not a shorter file */
+static bool test_gzip_truncated()
+{
+    TempFile file(".nt.gz");
+    file.write("");
+    append_gzip_member(file.name(), numbered_lines(0, 20000));
+
+    FILE *f = fopen(file.name(), "rb");
+    string data;
+    char buf[4096];
+    size_t n;
+    while (f && (n = fread(buf, 1, sizeof(buf), f)) != 0) {
+        data.append(buf, n);
+    }
+    if (f) {
+        fclose(f);
+    }
+    file.write(data.substr(0, data.size() / 2));
+
+    try {
+        read_all(file.name());
+    } catch (std::exception &e) {
+        return check_value(e.what(), "Truncated gzip data", "error");
+    }
+    return check(false, "reading a truncated file fails");
+}
+#endif
+
+static const struct
+{
+    const char *name;
+    bool (*run)();
+} TESTS[] = {
+    { "escapes", &test_escapes },
+    { "closing_quote", &test_closing_quote },
+    { "blank_labels", &test_blank_labels },
+    { "bom_and_crlf", &test_bom_and_crlf },
+    { "nquads_graph", &test_nquads_graph },
+    { "error_lines", &test_error_lines },
+#ifdef RDF_FIREBIRD_HAVE_ZLIB
+    { "gzip_members", &test_gzip_members },
+    { "gzip_chunk_boundaries", &test_gzip_chunk_boundaries },
+    { "gzip_truncated", &test_gzip_truncated },
+#endif
+};
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    for (const auto &test : TESTS) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || strcmp(argv[i], test.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        bool ok;
+        try {
+            ok = test.run();
+        } catch (std::exception &e) {
+            cerr << "unexpected error: " << e.what() << "\n";
+            ok = false;
+        }
+        cout << (ok ? "PASS " : "FAIL ") << test.name << "\n";
+        failed += ok ? 0 : 1;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,739 @@
+/*
+ * rdf_firebird_benchmark.cpp - import and query benchmarks
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "rdf_storage_firebird.h"
+#include "Metrics.h"
+#include "ZipfGenerator.h"
+
+
+using namespace std;
+
+namespace {
+
+using bench::Random;
+using bench::ZipfGenerator;
+
+struct Config
+{
+    string dbName;
+    string server = "localhost";
+    string user = "sysdba";
+    string password = "masterkey";
+    string storageOptions;
+    string output;
+    bool isNew = false;
+
+    unsigned int subjects = 10000;
+    unsigned int predicates = 50;
+    unsigned int literals = 20000;
+    unsigned int contexts = 10;
+    unsigned int triples = 100000;
+    unsigned int adds = 10000;
+    unsigned int queries = 200;
+    unsigned int removes = 5000;
+    unsigned int batch = 1000;
+    double zipf = 1.0;
+    uint64_t seed = 1;
+};
+
+/** a generated statement, nodes are numbered */
+struct Triple
+{
+    unsigned int s;
+    unsigned int p;
+    unsigned int o;
+    bool literal;
+    unsigned int c;
+};
+
+class DataGenerator
+{
+public:
+    explicit DataGenerator(const Config &cfg)
+            : subjects_(cfg.subjects, cfg.zipf),
+              predicates_(cfg.predicates, cfg.zipf),
+              literals_(cfg.literals, cfg.zipf),
+              contexts_(cfg.contexts, cfg.zipf),
+              hasContexts_(cfg.contexts != 0)
+    {
+    }
+
+    Triple operator()(Random &r) const
+    {
+        Triple t;
+        t.s = subjects_(r);
+        t.p = predicates_(r);
+        t.literal = (r.next() & 1) != 0;
+        t.o = t.literal ? literals_(r) : subjects_(r);
+        t.c = hasContexts_ ? contexts_(r) : 0;
+        return t;
+    }
+
+private:
+    ZipfGenerator subjects_;
+    ZipfGenerator predicates_;
+    ZipfGenerator literals_;
+    ZipfGenerator contexts_;
+    bool hasContexts_;
+};
+
+/** creates the librdf nodes of generated statements */
+class NodeFactory
+{
+public:
+    NodeFactory(librdf_world *world, bool contexts)
+            : world_(world), contexts_(contexts),
+              integer_(librdf_new_uri(world, (const unsigned char*)
+                            "http://www.w3.org/2001/XMLSchema#integer"),
+                       &librdf_free_uri)
+    {
+    }
+
+    librdf_node *resource(const char *kind, unsigned int n) const
+    {
+        char uri[96];
+        snprintf(uri, sizeof(uri), "http://example.org/%s/%u", kind, n);
+        return librdf_new_node_from_uri_string(world_,
+                                               (const unsigned char*) uri);
+    }
+
+    /** plain, language tagged and typed literals in turn */
+    librdf_node *literal(unsigned int n) const
+    {
+        char val[64];
+        switch (n % 3) {
+        case 0:
+            snprintf(val, sizeof(val), "literal value %u", n);
+            return librdf_new_node_from_literal(world_,
+                                    (const unsigned char*) val, nullptr, 0);
+        case 1:
+            snprintf(val, sizeof(val), "text %u", n);
+            return librdf_new_node_from_literal(world_,
+                                    (const unsigned char*) val, "en", 0);
+        default:
+            snprintf(val, sizeof(val), "%u", n);
+            return librdf_new_node_from_typed_literal(world_,
+                        (const unsigned char*) val, nullptr, integer_.get());
+        }
+    }
+
+    librdf_statement *statement(const Triple &t, unsigned int mask = 7) const
+    {
+        return librdf_new_statement_from_nodes(world_,
+                (mask & 4) ? resource("resource", t.s) : nullptr,
+                (mask & 2) ? resource("property", t.p) : nullptr,
+                !(mask & 1) ? nullptr : t.literal ? literal(t.o) :
+                                            resource("resource", t.o));
+    }
+
+    /** null without contexts, free with librdf_free_node() */
+    librdf_node *context(const Triple &t) const
+    {
+        return contexts_ ? resource("graph", t.c) : nullptr;
+    }
+
+private:
+    librdf_world *world_;
+    bool contexts_;
+    shared_ptr<librdf_uri> integer_;
+};
+
+/** a stream over the statements of a vector, which keeps them */
+struct VectorStream
+{
+    const vector<librdf_statement*> *statements;
+    size_t pos;
+
+    static int isEnd(void *ctx)
+    {
+        VectorStream *vs = (VectorStream*) ctx;
+        return vs->pos >= vs->statements->size();
+    }
+
+    static int next(void *ctx)
+    {
+        VectorStream *vs = (VectorStream*) ctx;
+        vs->pos++;
+        return isEnd(ctx);
+    }
+
+    static void *get(void *ctx, int flags)
+    {
+        VectorStream *vs = (VectorStream*) ctx;
+        if (flags == LIBRDF_ITERATOR_GET_METHOD_GET_CONTEXT) {
+            return nullptr;
+        }
+        return (*vs->statements)[vs->pos];
+    }
+
+    static void finished(void *ctx)
+    {
+        delete (VectorStream*) ctx;
+    }
+
+    static librdf_stream *make(librdf_world *world,
+                               const vector<librdf_statement*> &statements)
+    {
+        return librdf_new_stream(world, new VectorStream{&statements, 0},
+                                 &isEnd, &next, &get, &finished);
+    }
+};
+
+/** the measurements of one workload */
+struct Result
+{
+    string name;
+    uint64_t operations = 0;
+    // statements added, found, serialised or removed
+    uint64_t rows = 0;
+    double seconds = 0;
+    metrics::LatencyHistogram latency;
+};
+
+typedef chrono::steady_clock Clock;
+
+static uint64_t elapsed_ns(Clock::time_point start)
+{
+    return (uint64_t) chrono::duration_cast<chrono::nanoseconds>(
+                                        Clock::now() - start).count();
+}
+
+/** time op() once per operation, op returns the rows it handled */
+template <typename Op>
+static void measure(Result &res, unsigned int count, Op op)
+{
+    const Clock::time_point begin = Clock::now();
+    for (unsigned int i = 0; i != count; ++i) {
+        const Clock::time_point start = Clock::now();
+        res.rows += op(i);
+        res.latency.record(elapsed_ns(start));
+        res.operations++;
+    }
+    res.seconds = elapsed_ns(begin) / 1e9;
+}
+
+static uint64_t count_stream(librdf_stream *stream)
+{
+    uint64_t rows = 0;
+    if (!stream) {
+        return 0;
+    }
+    while (!librdf_stream_end(stream)) {
+        rows++;
+        librdf_stream_next(stream);
+    }
+    librdf_free_stream(stream);
+    return rows;
+}
+
+static string shape_name(unsigned int shape)
+{
+    // bound positions: 8 subject, 4 predicate, 2 object, 1 context
+    string name = "find_";
+    name += (shape & 8) ? 's' : '?';
+    name += (shape & 4) ? 'p' : '?';
+    name += (shape & 2) ? 'o' : '?';
+    name += (shape & 1) ? 'c' : '?';
+    return name;
+}
+
+class Benchmark
+{
+public:
+    Benchmark(const Config &cfg, librdf_world *world, librdf_model *model)
+            : cfg_(cfg), world_(world), model_(model),
+              generate_(cfg), nodes_(world, cfg.contexts != 0),
+              random_(cfg.seed)
+    {
+    }
+
+    void run()
+    {
+        for (unsigned int i = 0; i != cfg_.triples; ++i) {
+            data_.push_back(generate_(random_));
+        }
+
+        bulkImport();
+        incrementalAdd();
+        contains();
+        for (unsigned int shape = 0; shape != 16; ++shape) {
+            if ((shape & 1) && cfg_.contexts == 0) {
+                continue;
+            }
+            find(shape);
+        }
+        serialise();
+        remove();
+    }
+
+    const vector<Result> &results() const
+    {
+        return results_;
+    }
+
+private:
+    void commit()
+    {
+        librdf_storage_transaction_commit(librdf_model_get_storage(model_));
+    }
+
+    const Triple &existing()
+    {
+        return data_[random_.below((unsigned int) data_.size())];
+    }
+
+    /** add the statements in batches of the same context */
+    void bulkImport()
+    {
+        vector<vector<size_t>> byContext(max(cfg_.contexts, 1u));
+        for (size_t i = 0; i != data_.size(); ++i) {
+            byContext[data_[i].c].push_back(i);
+        }
+
+        vector<pair<unsigned int, vector<size_t>>> batches;
+        for (unsigned int c = 0; c != byContext.size(); ++c) {
+            const vector<size_t> &ids = byContext[c];
+            for (size_t first = 0; first < ids.size(); first += cfg_.batch) {
+                batches.emplace_back(c, vector<size_t>(ids.begin() + first,
+                        ids.begin() + min(ids.size(), first + cfg_.batch)));
+            }
+        }
+
+        Result res;
+        res.name = "bulk_import";
+        measure(res, (unsigned int) batches.size(), [&](unsigned int b) {
+            vector<librdf_statement*> statements;
+            for (size_t i : batches[b].second) {
+                statements.push_back(nodes_.statement(data_[i]));
+            }
+            librdf_node *context = nodes_.context(data_[batches[b].second[0]]);
+            librdf_stream *stream = VectorStream::make(world_, statements);
+            librdf_model_context_add_statements(model_, context, stream);
+            librdf_free_stream(stream);
+            if (context) {
+                librdf_free_node(context);
+            }
+            for (librdf_statement *st : statements) {
+                librdf_free_statement(st);
+            }
+            return (uint64_t) statements.size();
+        });
+        timeCommit(res);
+        results_.push_back(move(res));
+    }
+
+    /** add statements one at a time, half of them already stored */
+    void incrementalAdd()
+    {
+        Result res;
+        res.name = "incremental_add";
+        measure(res, cfg_.adds, [&](unsigned int) {
+            Triple t = (random_.next() & 1) ? existing() : generate_(random_);
+            librdf_statement *st = nodes_.statement(t);
+            librdf_node *context = nodes_.context(t);
+            librdf_model_context_add_statement(model_, context, st);
+            if (context) {
+                librdf_free_node(context);
+            }
+            librdf_free_statement(st);
+            data_.push_back(t);
+            return 1;
+        });
+        timeCommit(res);
+        results_.push_back(move(res));
+    }
+
+    /** look up statements, half of them with a subject never stored */
+    void contains()
+    {
+        Result res;
+        res.name = "contains_statement";
+        measure(res, cfg_.queries, [&](unsigned int i) {
+            Triple t = existing();
+            if (i & 1) {
+                t.s += cfg_.subjects;
+            }
+            librdf_statement *st = nodes_.statement(t);
+            librdf_node *context = nodes_.context(t);
+            int found;
+            if (context) {
+                // contains_statement only looks among the statements
+                // without a context
+                librdf_stream *stream = librdf_model_find_statements_in_context(
+                                                    model_, st, context);
+                found = stream && !librdf_stream_end(stream);
+                if (stream) {
+                    librdf_free_stream(stream);
+                }
+                librdf_free_node(context);
+            } else {
+                found = librdf_model_contains_statement(model_, st);
+            }
+            librdf_free_statement(st);
+            return found > 0 ? 1 : 0;
+        });
+        results_.push_back(move(res));
+    }
+
+    /** match patterns with the nodes of stored statements bound */
+    void find(unsigned int shape)
+    {
+        Result res;
+        res.name = shape_name(shape);
+        // without bound statement nodes much of the store is read
+        const unsigned int count = (shape & ~1u) ? cfg_.queries :
+                                                   min(cfg_.queries, 3u);
+        measure(res, count, [&](unsigned int) {
+            const Triple &t = existing();
+            librdf_statement *pattern = nodes_.statement(t, shape >> 1);
+            librdf_node *context = (shape & 1) ? nodes_.context(t) : nullptr;
+            librdf_stream *stream = context ?
+                    librdf_model_find_statements_in_context(model_, pattern,
+                                                            context) :
+                    librdf_model_find_statements(model_, pattern);
+            const uint64_t rows = count_stream(stream);
+            if (context) {
+                librdf_free_node(context);
+            }
+            librdf_free_statement(pattern);
+            return rows;
+        });
+        results_.push_back(move(res));
+    }
+
+    /** write all statements as N-Triples */
+    void serialise()
+    {
+        Result res;
+        res.name = "serialise";
+        librdf_serializer *ser = librdf_new_serializer(world_, "ntriples",
+                                                       nullptr, nullptr);
+        if (!ser) {
+            cerr << "No ntriples serializer, skipping serialise\n";
+            return;
+        }
+        shared_ptr<librdf_serializer> serializer(ser, &librdf_free_serializer);
+
+        measure(res, 1, [&](unsigned int) {
+            librdf_stream *stream = librdf_model_as_stream(model_);
+            size_t length = 0;
+            unsigned char *text = librdf_serializer_serialize_stream_to_counted_string(
+                                serializer.get(), nullptr, stream, &length);
+            librdf_free_stream(stream);
+
+            uint64_t lines = 0;
+            if (text) {
+                lines = (uint64_t) count(text, text + length, '\n');
+                librdf_free_memory(text);
+            }
+            return lines;
+        });
+        results_.push_back(move(res));
+    }
+
+    /** remove distinct stored statements one at a time */
+    void remove()
+    {
+        Result res;
+        res.name = "remove";
+        // the generated and incrementally added statements repeat some of
+        // the stored ones, each is removed once
+        auto key = [](const Triple &t) {
+            return make_tuple(t.s, t.p, t.o, t.literal, t.c);
+        };
+        sort(data_.begin(), data_.end(), [&](const Triple &a,
+                                             const Triple &b) {
+            return key(a) < key(b);
+        });
+        data_.erase(unique(data_.begin(), data_.end(), [&](const Triple &a,
+                                                           const Triple &b) {
+            return key(a) == key(b);
+        }), data_.end());
+
+        const unsigned int count = min(cfg_.removes,
+                                       (unsigned int) data_.size());
+        // a deterministic sample without repetitions
+        for (unsigned int i = 0; i != count; ++i) {
+            swap(data_[i], data_[i + random_.below(
+                                (unsigned int) data_.size() - i)]);
+        }
+
+        measure(res, count, [&](unsigned int i) {
+            librdf_statement *st = nodes_.statement(data_[i]);
+            librdf_node *context = nodes_.context(data_[i]);
+            librdf_model_context_remove_statement(model_, context, st);
+            if (context) {
+                librdf_free_node(context);
+            }
+            librdf_free_statement(st);
+            return 1;
+        });
+        timeCommit(res);
+        results_.push_back(move(res));
+    }
+
+    /** the commit at the end of a workload counts towards its time */
+    void timeCommit(Result &res)
+    {
+        const Clock::time_point start = Clock::now();
+        commit();
+        res.seconds += elapsed_ns(start) / 1e9;
+    }
+
+    const Config &cfg_;
+    librdf_world *world_;
+    librdf_model *model_;
+    DataGenerator generate_;
+    NodeFactory nodes_;
+    Random random_;
+    vector<Triple> data_;
+    vector<Result> results_;
+};
+
+static string json_string(const string &s)
+{
+    string out = "\"";
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += ch;
+        } else if ((unsigned char) ch < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", (unsigned int) ch);
+            out += esc;
+        } else {
+            out += ch;
+        }
+    }
+    return out + "\"";
+}
+
+static void write_json(ostream &os, const Config &cfg,
+                       const vector<Result> &results)
+{
+    char when[32];
+    const time_t now = time(nullptr);
+    strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    os << "{\n"
+       << "  \"benchmark\": \"librdf.firebird\",\n"
+       << "  \"timestamp\": \"" << when << "\",\n"
+       << "  \"config\": {\n"
+       << "    \"subjects\": " << cfg.subjects << ",\n"
+       << "    \"predicates\": " << cfg.predicates << ",\n"
+       << "    \"literals\": " << cfg.literals << ",\n"
+       << "    \"contexts\": " << cfg.contexts << ",\n"
+       << "    \"triples\": " << cfg.triples << ",\n"
+       << "    \"adds\": " << cfg.adds << ",\n"
+       << "    \"queries\": " << cfg.queries << ",\n"
+       << "    \"removes\": " << cfg.removes << ",\n"
+       << "    \"batch\": " << cfg.batch << ",\n"
+       << "    \"zipf\": " << cfg.zipf << ",\n"
+       << "    \"seed\": " << cfg.seed << ",\n"
+       << "    \"storage_options\": " << json_string(cfg.storageOptions) << "\n"
+       << "  },\n"
+       << "  \"results\": [";
+
+    for (size_t i = 0; i != results.size(); ++i) {
+        const Result &r = results[i];
+        const double secs = r.seconds > 0 ? r.seconds : 1e-9;
+        os << (i ? "," : "") << "\n    {"
+           << "\"name\": " << json_string(r.name)
+           << ", \"operations\": " << r.operations
+           << ", \"rows\": " << r.rows
+           << ", \"seconds\": " << r.seconds
+           << ", \"ops_per_sec\": " << r.operations / secs
+           << ", \"rows_per_sec\": " << r.rows / secs
+           << ", \"p50_us\": " << r.latency.percentile(0.5) / 1000.0
+           << ", \"p99_us\": " << r.latency.percentile(0.99) / 1000.0
+           << ", \"max_us\": " << r.latency.max() / 1000.0
+           << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+static void print_summary(const vector<Result> &results)
+{
+    char line[160];
+    snprintf(line, sizeof(line), "%-20s %10s %10s %12s %12s %12s\n",
+             "workload", "ops", "rows", "ops/s", "p50 us", "p99 us");
+    cerr << line;
+    for (const Result &r : results) {
+        snprintf(line, sizeof(line), "%-20s %10llu %10llu %12.1f %12.1f %12.1f\n",
+                 r.name.c_str(), (unsigned long long) r.operations,
+                 (unsigned long long) r.rows,
+                 r.operations / (r.seconds > 0 ? r.seconds : 1e-9),
+                 r.latency.percentile(0.5) / 1000.0,
+                 r.latency.percentile(0.99) / 1000.0);
+        cerr << line;
+    }
+}
+
+static int usage(char *argv[])
+{
+    cout << "Synopsys:\n"
+         << "    " << argv[0] << " <db_connection> [-o <json_file>] [options]\n"
+         << "\n"
+         << "db_connection:\n"
+         << "    -d <db_name> [-new] [-s <server>] [-u <user>] [-p <password>]\n"
+         << "    an empty server (-s '') opens the database with the embedded\n"
+         << "    engine\n"
+         << "\n"
+         << "options:\n"
+         << "    -subjects <n>    distinct subjects (10000)\n"
+         << "    -predicates <n>  distinct predicates (50)\n"
+         << "    -literals <n>    distinct literals (20000)\n"
+         << "    -contexts <n>    distinct contexts, 0 for none (10)\n"
+         << "    -triples <n>     statements of the bulk import (100000)\n"
+         << "    -adds <n>        statements added one at a time (10000)\n"
+         << "    -queries <n>     lookups per pattern shape (200)\n"
+         << "    -removes <n>     statements removed one at a time (5000)\n"
+         << "    -batch <n>       statements per bulk import call (1000)\n"
+         << "    -zipf <s>        Zipf exponent of the node frequencies (1.0)\n"
+         << "    -seed <n>        random seed (1)\n"
+         << "    -opt <options>   more storage options, e.g. \"hash_lookup='yes'\"\n"
+         << "\n"
+         << "The results are written as JSON to the file given with -o, or\n"
+         << "to the standard output, and summarized on the standard error.\n";
+    return 1;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    Config cfg;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = (i + 1) < argc;
+        const char *value = hasValue ? argv[i + 1] : "";
+        unsigned int *count = nullptr;
+
+        if (strcmp(argv[i], "-new") == 0) {
+            cfg.isNew = true;
+            continue;
+        } else if (strcmp(argv[i], "-h") == 0) {
+            usage(argv);
+            return 0;
+        } else if (!hasValue) {
+            return usage(argv);
+        } else if (strcmp(argv[i], "-d") == 0) {
+            cfg.dbName = value;
+        } else if (strcmp(argv[i], "-s") == 0) {
+            cfg.server = value;
+        } else if (strcmp(argv[i], "-u") == 0) {
+            cfg.user = value;
+        } else if (strcmp(argv[i], "-p") == 0) {
+            cfg.password = value;
+        } else if (strcmp(argv[i], "-o") == 0) {
+            cfg.output = value;
+        } else if (strcmp(argv[i], "-opt") == 0) {
+            cfg.storageOptions = value;
+        } else if (strcmp(argv[i], "-zipf") == 0) {
+            cfg.zipf = strtod(value, nullptr);
+        } else if (strcmp(argv[i], "-seed") == 0) {
+            cfg.seed = strtoull(value, nullptr, 10);
+        } else if (strcmp(argv[i], "-subjects") == 0) {
+            count = &cfg.subjects;
+        } else if (strcmp(argv[i], "-predicates") == 0) {
+            count = &cfg.predicates;
+        } else if (strcmp(argv[i], "-literals") == 0) {
+            count = &cfg.literals;
+        } else if (strcmp(argv[i], "-contexts") == 0) {
+            count = &cfg.contexts;
+        } else if (strcmp(argv[i], "-triples") == 0) {
+            count = &cfg.triples;
+        } else if (strcmp(argv[i], "-adds") == 0) {
+            count = &cfg.adds;
+        } else if (strcmp(argv[i], "-queries") == 0) {
+            count = &cfg.queries;
+        } else if (strcmp(argv[i], "-removes") == 0) {
+            count = &cfg.removes;
+        } else if (strcmp(argv[i], "-batch") == 0) {
+            count = &cfg.batch;
+        } else {
+            return usage(argv);
+        }
+
+        if (count) {
+            *count = (unsigned int) strtoul(value, nullptr, 10);
+        }
+        i++;
+    }
+
+    if (cfg.dbName.empty() || cfg.triples == 0 || cfg.batch == 0 ||
+            cfg.subjects == 0 || cfg.predicates == 0 || cfg.literals == 0) {
+        cout << "Database name (-d switch) and non-zero node counts are "
+                "required!\n";
+        return usage(argv);
+    }
+
+    shared_ptr<librdf_world> world(librdf_new_world(), &librdf_free_world);
+    librdf_world_open(world.get());
+    librdf_init_storage_firebird(world.get());
+
+    string options = "user='" + cfg.user + "', password='" + cfg.password +
+                     "', new='" + (cfg.isNew ? "yes" : "no") + "'";
+    if (!cfg.server.empty()) {
+        options += ", host='" + cfg.server + "'";
+    }
+    if (!cfg.storageOptions.empty()) {
+        options += ", " + cfg.storageOptions;
+    }
+
+    shared_ptr<librdf_storage> store(
+                    librdf_new_storage(world.get(), LIBRDF_STORAGE_FIREBIRD,
+                                       cfg.dbName.c_str(), options.c_str()),
+                    &librdf_free_storage);
+    if (!store) {
+        cerr << "Failed to open the storage\n";
+        return 2;
+    }
+
+    shared_ptr<librdf_model> model(
+                    librdf_new_model(world.get(), store.get(), nullptr),
+                    &librdf_free_model);
+    if (!model) {
+        return 2;
+    }
+
+    Benchmark bench(cfg, world.get(), model.get());
+    bench.run();
+
+    print_summary(bench.results());
+    if (cfg.output.empty()) {
+        write_json(cout, cfg, bench.results());
+    } else {
+        ofstream ofs(cfg.output.c_str());
+        write_json(ofs, cfg, bench.results());
+        if (!ofs) {
+            cerr << "Failed to write " << cfg.output << "\n";
+            return 3;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * rdf_firebird_test.cpp - regression tests against a test database
+ *
+ * This is part of the "librdf.firebird" storage module for the
+ * "Redland RDF Library" (http://librdf.org/) that stores and
+ * retrieves RDF data from a Firebird database.
+ *
+ * @created: Oct 18, 2026
+ *
+ * @copyright: Copyright (c) 2015 Robert Zavalczki, distributed
+ * under the terms and conditions of the Lesser GNU General
+ * Public License version 2.1
+ */
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+#include "rdf_storage_firebird.h"
+
+
+using namespace std;
+
+struct TestDb
+{
+    string dbName;
+    string server = "localhost";
+    string userName = "sysdba";
+    string password = "masterkey";
+};
+
+/**
+ * a prefix unique to this run, the tests use new nodes so that they can run
+ * repeatedly against the same database
+ */
+static string run_prefix()
+{
+    return "http://example.org/rdf_firebird_test/" +
+           to_string((long long) time(nullptr)) + "-" +
+           to_string((long long) getpid()) + "/";
+}
+
+static shared_ptr<librdf_storage> open_storage(librdf_world *world,
+                                               const TestDb &db,
+                                               const char *extra_options = "")
+{
+    const string options = "new='yes', host='" + db.server + "', user='" +
+                           db.userName + "', password='" + db.password + "'" +
+                           extra_options;
+    return shared_ptr<librdf_storage>(
+                    librdf_new_storage(world, LIBRDF_STORAGE_FIREBIRD,
+                                       db.dbName.c_str(), options.c_str()),
+                    &librdf_free_storage);
+}
+
+static librdf_statement *new_statement(librdf_world *world, const string &s,
+                                       const string &p, const string &o)
+{
+    return librdf_new_statement_from_nodes(world,
+                librdf_new_node_from_uri_string(world,
+                                        (const unsigned char*) s.c_str()),
+                librdf_new_node_from_uri_string(world,
+                                        (const unsigned char*) p.c_str()),
+                librdf_new_node_from_literal(world,
+                                        (const unsigned char*) o.c_str(),
+                                        nullptr, 0));
+}
+
+/** the number of statements matching pattern in context (NULL for any) */
+static int count_matching(librdf_storage *storage, librdf_statement *pattern,
+                          librdf_node *context)
+{
+    librdf_stream *stream = context ?
+            librdf_storage_find_statements_in_context(storage, pattern,
+                                                      context) :
+            librdf_storage_find_statements(storage, pattern);
+    if (!stream) {
+        return -1;
+    }
+    int count = 0;
+    for (; !librdf_stream_end(stream); librdf_stream_next(stream)) {
+        count++;
+    }
+    librdf_free_stream(stream);
+    return count;
+}
+
+/** a stream handing out the same statement a number of times */
+struct RepeatStream
+{
+    librdf_statement *statement;
+    int remaining;
+
+    static int isEnd(void *context)
+    {
+        return ((RepeatStream*) context)->remaining == 0;
+    }
+
+    static int next(void *context)
+    {
+        RepeatStream *rs = (RepeatStream*) context;
+        return --rs->remaining == 0;
+    }
+
+    static void *get(void *context, int flags)
+    {
+        RepeatStream *rs = (RepeatStream*) context;
+        return flags == LIBRDF_ITERATOR_GET_METHOD_GET_OBJECT ?
+               rs->statement : nullptr;
+    }
+
+    static void finished(void * /* context */)
+    {
+    }
+};
+
+/** a statement repeated in one window of added statements is added once */
+static bool test_add_duplicate_in_window(librdf_world *world,
+                                         const TestDb &db)
+{
+    shared_ptr<librdf_storage> storage = open_storage(world, db);
+    if (!storage) {
+        return false;
+    }
+    const string prefix = run_prefix() + "window/";
+    librdf_statement *stmt = new_statement(world, prefix + "s", prefix + "p",
+                                           prefix + "o");
+    librdf_node *context = librdf_new_node_from_uri_string(world,
+                                    (const unsigned char*) prefix.c_str());
+
+    // all nodes are new, so none of them is probed for in TRIPLE
+    RepeatStream rs{stmt, 2};
+    librdf_stream *stream = librdf_new_stream(world, &rs, &RepeatStream::isEnd,
+                                              &RepeatStream::next,
+                                              &RepeatStream::get,
+                                              &RepeatStream::finished);
+    const int rc = librdf_storage_context_add_statements(storage.get(),
+                                                         context, stream);
+    librdf_free_stream(stream);
+
+    const int count = count_matching(storage.get(), stmt, context);
+    librdf_free_statement(stmt);
+    librdf_free_node(context);
+    if (rc != 0 || count != 1) {
+        cerr << "expected 1 statement, found " << count << "\n";
+        return false;
+    }
+    return true;
+}
+
+/** the native loader adds a line repeated in one window once */
+static bool test_load_duplicate_in_window(librdf_world *world,
+                                          const TestDb &db)
+{
+    shared_ptr<librdf_storage> storage = open_storage(world, db);
+    if (!storage) {
+        return false;
+    }
+    const string prefix = run_prefix() + "load/";
+    char fileName[] = "/tmp/rdf_firebird_test_XXXXXX";
+    const int fd = mkstemp(fileName);
+    if (fd < 0) {
+        return false;
+    }
+    const string line = "<" + prefix + "s> <" + prefix + "p> \"o\"@en .\n";
+    const string text = line + line;
+    const bool written = write(fd, text.data(), text.size()) ==
+                         (ssize_t) text.size();
+    close(fd);
+
+    librdf_node *context = librdf_new_node_from_uri_string(world,
+                                    (const unsigned char*) prefix.c_str());
+    const int64_t loaded = written ?
+            librdf_storage_firebird_load_file(storage.get(), fileName,
+                                              context) : -1;
+    unlink(fileName);
+
+    librdf_statement *stmt = librdf_new_statement_from_nodes(world,
+                librdf_new_node_from_uri_string(world,
+                            (const unsigned char*) (prefix + "s").c_str()),
+                librdf_new_node_from_uri_string(world,
+                            (const unsigned char*) (prefix + "p").c_str()),
+                librdf_new_node_from_literal(world,
+                            (const unsigned char*) "o", "en", 0));
+    const int count = count_matching(storage.get(), stmt, context);
+    librdf_free_statement(stmt);
+    librdf_free_node(context);
+    if (loaded < 0 || count != 1) {
+        cerr << "expected 1 statement, found " << count << "\n";
+        return false;
+    }
+    return true;
+}
+
+static const struct
+{
+    const char *name;
+    bool (*run)(librdf_world *world, const TestDb &db);
+} TESTS[] = {
+    { "add_duplicate_in_window", &test_add_duplicate_in_window },
+    { "load_duplicate_in_window", &test_load_duplicate_in_window },
+};
+
+static int usage(char *argv[])
+{
+    cout << "Synopsys:\n"
+         << "    " << argv[0] << " -d <db_name> [-s <server>] [-u <user>] "
+            "[-p <password>] [<test_name>...]\n"
+         << "\n"
+         << "Runs the named tests (all by default) against an existing "
+            "database,\n"
+         << "the schema objects are created if they don't exist.\n";
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    TestDb db;
+    int firstName = argc;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-d") == 0 && (i + 1) < argc) {
+            db.dbName = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && (i + 1) < argc) {
+            db.server = argv[++i];
+        } else if (strcmp(argv[i], "-u") == 0 && (i + 1) < argc) {
+            db.userName = argv[++i];
+        } else if (strcmp(argv[i], "-p") == 0 && (i + 1) < argc) {
+            db.password = argv[++i];
+        } else if (argv[i][0] == '-') {
+            return usage(argv);
+        } else {
+            firstName = i;
+            break;
+        }
+    }
+    if (db.dbName.empty()) {
+        return usage(argv);
+    }
+
+    shared_ptr<librdf_world> world(librdf_new_world(), &librdf_free_world);
+    librdf_world_open(world.get());
+    librdf_init_storage_firebird(world.get());
+
+    int failed = 0;
+    for (const auto &test : TESTS) {
+        bool selected = firstName == argc;
+        for (int i = firstName; i < argc; ++i) {
+            selected = selected || strcmp(argv[i], test.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        const bool ok = test.run(world.get(), db);
+        cout << (ok ? "PASS " : "FAIL ") << test.name << "\n";
+        failed += ok ? 0 : 1;
+    }
+    return failed ? 1 : 0;
+}
@@ -11,8 +11,10 @@
  * under the terms and conditions of the Lesser GNU General
  * Public License version 2.1
  */
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <initializer_list>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -42,14 +44,15 @@ static shared_ptr<librdf_storage> make_rdf_storage(librdf_world *world,
                                                 const char *user,
                                                 const char *password,
                                                 bool is_new = false,
-                                                bool update_index_stats = false)
+                                                bool update_index_stats = false,
+                                                const char *extra_options = "")
 {
     char options[2048];
     // "new='yes',host='localhost',user='sysdba',password='masterkey'"
     snprintf(options, sizeof(options),
-            "host='%s', user='%s', password='%s', new='%s', update_index_stats='%s'",
+            "host='%s', user='%s', password='%s', new='%s', update_index_stats='%s'%s",
             server, user, password, is_new ? "yes" : "no",
-            update_index_stats ? "yes" : "no");
+            update_index_stats ? "yes" : "no", extra_options);
 
     shared_ptr<librdf_storage> store(
                                 librdf_new_storage(world,
@@ -161,6 +164,39 @@ static bool import_file(librdf_world *world,
     return true;
 }
 
+/**
+ * Import an N-Triples or N-Quads file with the storage's own parser.
+ * \param context_uri as for import_file()
+ */
+static bool import_native_file(librdf_world *world,
+                               librdf_storage *storage,
+                               const char *file_name,
+                               const char *context_uri = nullptr)
+{
+    string file_uri = file_name;
+    if (file_uri.compare(0, 5, "file:") == 0) {
+        file_name += 5;
+    } else {
+        file_uri.insert(0, "file:");
+    }
+
+    librdf_node *context_node = nullptr;
+    if (context_uri) {
+        context_node = librdf_new_node_from_uri_string(world,
+                                (const unsigned char*) (*context_uri ?
+                                        context_uri : file_uri.c_str()));
+    }
+
+    const int64_t count = librdf_storage_firebird_load_file(storage, file_name,
+                                                            context_node);
+    librdf_free_node(context_node);
+    if (count < 0) {
+        return false;
+    }
+    cout << "Loaded " << count << " statements\n";
+    return true;
+}
+
 void run_query(librdf_world *world, librdf_model *model,
                const char *query_string, const char *outputFormat,
                const char *lang = "sparql")
@@ -192,6 +228,93 @@ void run_query(librdf_world *world, librdf_model *model,
     librdf_free_query_results(res);
 }
 
+/** print the statement pool counters of the match query shapes used */
+static void print_statement_pools(librdf_storage *store)
+{
+    const unsigned int count = librdf_storage_firebird_get_statement_pool_count();
+    for (unsigned int i = 0; i != count; ++i) {
+        librdf_storage_firebird_statement_pool_stats st;
+        if (librdf_storage_firebird_get_statement_pool_stats(store, i, &st) ||
+                st.prepares == 0) {
+            continue;
+        }
+        cerr << "match " << i << ": prepares " << st.prepares
+             << ", reuses " << st.reuses
+             << ", peak in use " << st.peak_in_use
+             << ", idle " << st.idle << "\n";
+    }
+}
+
+/** append a node in N-Triples syntax */
+static void write_ntriples_node(string &out, librdf_node *node)
+{
+    if (librdf_node_is_resource(node)) {
+        out += '<';
+        out += (const char*) librdf_uri_as_string(librdf_node_get_uri(node));
+        out += '>';
+    } else if (librdf_node_is_blank(node)) {
+        out += "_:";
+        out += (const char*) librdf_node_get_blank_identifier(node);
+    } else {
+        out += '"';
+        for (const char *p = (const char*) librdf_node_get_literal_value(node);
+                *p; ++p) {
+            switch (*p) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += *p;
+            }
+        }
+        out += '"';
+        const char *lang = librdf_node_get_literal_value_language(node);
+        librdf_uri *dt = librdf_node_get_literal_value_datatype_uri(node);
+        if (lang && *lang) {
+            out += '@';
+            out += lang;
+        } else if (dt) {
+            out += "^^<";
+            out += (const char*) librdf_uri_as_string(dt);
+            out += '>';
+        }
+    }
+}
+
+/** print a logged change as "<seq> +|- <N-Quads statement>" */
+static int print_change(void * /* user_data */, int64_t seq, int op,
+                        librdf_statement *statement, librdf_node *context)
+{
+    string line = to_string(seq);
+    line += op > 0 ? " + " : " - ";
+    write_ntriples_node(line, librdf_statement_get_subject(statement));
+    line += ' ';
+    write_ntriples_node(line, librdf_statement_get_predicate(statement));
+    line += ' ';
+    write_ntriples_node(line, librdf_statement_get_object(statement));
+    if (context) {
+        line += ' ';
+        write_ntriples_node(line, context);
+    }
+    line += " .\n";
+    cout << line;
+    return 0;
+}
+
+/** print the changes logged after since, return the last one's number */
+static int64_t print_changes(librdf_storage *store, int64_t since)
+{
+    for (;;) {
+        const int64_t last = librdf_storage_firebird_get_changes(store, since,
+                                                    1000, &print_change,
+                                                    nullptr);
+        if (last <= since) {
+            return last;
+        }
+        since = last;
+    }
+}
+
 static int usage(int /* argc */, char *argv[])
 {
     cout << "Synopsys:\n"
@@ -200,6 +323,30 @@ static int usage(int /* argc */, char *argv[])
          << "\n"
          << "db_connection:\n"
          << "    -d <db_name> [-new] [-s <server>] [-u <user>] [-p <password>]\n"
+         << "\n"
+         << "schema options:\n"
+         << "    -composite   with -new, use composite indexes on TRIPLE\n"
+         << "    -unified     with -new, use the unified S_ID/O_ID TRIPLE layout\n"
+         << "    -hash        with -new, look up URIs and literals by hash\n"
+         << "    -long        with -new, store long literals in a BLOB column\n"
+         << "    -count       with -new, maintain the statement count\n"
+         << "    -migrate     convert an existing database to the unified layout\n"
+         << "    -fastload    deactivate the TRIPLE indexes while importing\n"
+         << "    -bloom       skip lookups of new statements with a bloom filter\n"
+         << "    -prepare     prepare all statements when opening the database\n"
+         << "    -log         with -new, log the added and removed statements\n"
+         << "    -native      import .nt and .nq files without the raptor parser\n"
+         << "                 (always done for .nt.gz, .nq.gz, .nt.zst and .nq.zst)\n"
+         << "\n"
+         << "maintenance:\n"
+         << "    -gc <n>      delete unused nodes, examining up to n IDs per node table\n"
+         << "    -changes <n> print the logged changes after the watermark n (0 for all)\n"
+         << "                 and the new watermark\n"
+         << "    -trimlog <n> delete the logged changes up to the watermark n\n"
+         << "    -poolstats   print the statement pool counters after the query\n"
+         << "    -stats       print the operation statistics after the query\n"
+         << "    -slow <ms>   log match queries taking at least ms milliseconds\n"
+         << "    -explain     log the plans of the match queries\n"
          << "\n";
     return 1;
 }
@@ -216,6 +363,14 @@ int main(int argc, char *argv[])
     string queryFile;
     string outform = "csv";
     bool is_new = false;
+    bool migrate = false;
+    unsigned int gcNodes = 0;
+    int64_t changesSince = -1;
+    int64_t trimWatermark = -1;
+    bool poolStats = false;
+    bool stats = false;
+    bool nativeImport = false;
+    string extraOptions;
 
     for (int i = 0; i < argc; ++i) {
 
@@ -249,6 +404,51 @@ int main(int argc, char *argv[])
             i++;
         } else if (strcmp(argv[i], "-new") == 0) {
             is_new = true;
+        } else if (strcmp(argv[i], "-composite") == 0) {
+            extraOptions += ", composite_indexes='yes'";
+        } else if (strcmp(argv[i], "-unified") == 0) {
+            extraOptions += ", unified_nodes='yes'";
+        } else if (strcmp(argv[i], "-hash") == 0) {
+            extraOptions += ", hash_lookup='yes'";
+        } else if (strcmp(argv[i], "-long") == 0) {
+            extraOptions += ", long_literals='yes'";
+        } else if (strcmp(argv[i], "-count") == 0) {
+            extraOptions += ", triple_count='yes'";
+        } else if (strcmp(argv[i], "-migrate") == 0) {
+            extraOptions += ", migrate_unified_nodes='yes'";
+            migrate = true;
+        } else if (strcmp(argv[i], "-fastload") == 0) {
+            extraOptions += ", fastload='yes'";
+        } else if (strcmp(argv[i], "-bloom") == 0) {
+            extraOptions += ", bloom_filter='yes'";
+        } else if (strcmp(argv[i], "-prepare") == 0) {
+            extraOptions += ", prepare_statements='yes'";
+        } else if (strcmp(argv[i], "-log") == 0) {
+            extraOptions += ", triple_log='yes'";
+        } else if (strcmp(argv[i], "-changes") == 0 && (i + 1) < argc) {
+            changesSince = strtoll(argv[i + 1], nullptr, 10);
+            i++;
+        } else if (strcmp(argv[i], "-trimlog") == 0 && (i + 1) < argc) {
+            trimWatermark = strtoll(argv[i + 1], nullptr, 10);
+            i++;
+        } else if (strcmp(argv[i], "-native") == 0) {
+            nativeImport = true;
+        } else if (strcmp(argv[i], "-gc") == 0 && (i + 1) < argc) {
+            // garbage collect unused nodes
+            gcNodes = (unsigned int) strtoul(argv[i + 1], nullptr, 10);
+            i++;
+        } else if (strcmp(argv[i], "-poolstats") == 0) {
+            poolStats = true;
+        } else if (strcmp(argv[i], "-stats") == 0) {
+            stats = true;
+        } else if (strcmp(argv[i], "-explain") == 0) {
+            extraOptions += ", explain_plans='yes'";
+        } else if (strcmp(argv[i], "-slow") == 0 && (i + 1) < argc) {
+            // slow query log threshold
+            extraOptions += ", slow_query_ms='";
+            extraOptions += argv[i + 1];
+            extraOptions += "'";
+            i++;
         } else if (strcmp(argv[i], "-h") == 0) {
             // database connection options
             usage(argc, argv);
@@ -265,7 +465,9 @@ int main(int argc, char *argv[])
         return usage(argc, argv);
     }
 
-    if (importFile.empty() && queryFile.empty()) {
+    const bool changeLog = changesSince >= 0 || trimWatermark >= 0;
+    if (importFile.empty() && queryFile.empty() && !migrate && !gcNodes &&
+            !changeLog) {
         return usage(argc, argv);
     }
 
@@ -277,16 +479,68 @@ int main(int argc, char *argv[])
     shared_ptr<librdf_storage> store = make_rdf_storage(world.get(),
                                             dbName.c_str(), server.c_str(),
                                             userName.c_str(), password.c_str(),
-                                            is_new);
+                                            is_new, false, extraOptions.c_str());
     if (!store) {
         return 1;
     }
 
+    if (gcNodes) {
+        int64_t deleted = librdf_storage_firebird_collect_garbage(store.get(),
+                                                                  gcNodes);
+        if (deleted < 0) {
+            return 1;
+        }
+        cout << "Deleted " << deleted << " unused nodes\n";
+    }
+
+    if (changesSince >= 0) {
+        const int64_t watermark = print_changes(store.get(), changesSince);
+        if (watermark < 0) {
+            return 1;
+        }
+        cerr << "watermark " << watermark << "\n";
+    }
+
+    if (trimWatermark >= 0 &&
+            librdf_storage_firebird_trim_changes(store.get(), trimWatermark)) {
+        return 1;
+    }
+
+    if (importFile.empty() && queryFile.empty()) {
+        // the database was migrated, garbage collected or its change log read
+        return 0;
+    }
+
     shared_ptr<librdf_model> model = make_rdf_model(world.get(), store.get());
     if (!model) {
         return 1;
     }
 
+    // compressed files are decompressed by the storage's own loader
+    string fileName = importFile;
+    bool compressed = false;
+    for (const char *suffix : { ".gz", ".zst" }) {
+        const size_t len = strlen(suffix);
+        if (fileName.size() > len &&
+                fileName.compare(fileName.size() - len, len, suffix) == 0) {
+            fileName.resize(fileName.size() - len);
+            compressed = true;
+        }
+    }
+    const string::size_type ext = fileName.find_last_of('.');
+    const bool ntriples = ext != string::npos &&
+                          (fileName.compare(ext, string::npos, ".nt") == 0 ||
+                           fileName.compare(ext, string::npos, ".nq") == 0);
+    if (compressed && !ntriples) {
+        cout << "Only N-Triples (.nt) and N-Quads (.nq) files can be imported "
+                "compressed\n";
+        return 1;
+    }
+    if (ntriples && (nativeImport || compressed)) {
+        return import_native_file(world.get(), store.get(), importFile.c_str(),
+                        contextUri.empty() ? nullptr : contextUri.c_str()) ? 0 : 1;
+    }
+
     if (!importFile.empty()) {
         return import_file(world.get(), model.get(), importFile.c_str(),
                         nullptr, nullptr,
@@ -308,5 +562,15 @@ int main(int argc, char *argv[])
     }
 
     run_query(world.get(), model.get(), query.c_str(), outform.c_str());
+    if (poolStats) {
+        print_statement_pools(store.get());
+    }
+    if (stats) {
+        char *text = librdf_storage_firebird_get_stats(store.get());
+        if (text) {
+            cerr << text;
+            free(text);
+        }
+    }
     return 0;
 }
@@ -17,16 +17,35 @@
 #include "fb/DbRowProxy.h"
 #include "fb/DbStatement.h"
 #include "fb/DbTransaction.h"
+#include "BloomFilter.h"
 #include "GenericCache.h"
+#include "Metrics.h"
+#include "NodeHash.h"
+#include "NTriplesReader.h"
 #include "PreparedStatements.h"
 #include "RdfDbSchemaBuilder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <ctime>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 
 const char * const LIBRDF_STORAGE_FIREBIRD = "http://librdf.org/docs/api/redland-storage-module-firebird.html";
+const char * const LIBRDF_STORAGE_FIREBIRD_SHORT = "firebird";
 
 // all macros should go here
 #define RET_ERROR 1
@@ -49,6 +68,112 @@ using fb::DbStatement;
 using std::string;
 
 
+/** tables whose inserted and deleted rows are counted, see ChangedRows */
+enum ChangedTable : unsigned int
+{
+    CHANGED_RESOURCE,
+    CHANGED_BNODE,
+    CHANGED_LITERAL,
+    CHANGED_CONTEXT,
+    CHANGED_TRIPLE,
+    CHANGED_TABLE_COUNT
+};
+
+/**
+ * node IDs of a statement, subject and object IDs are tagged with their
+ * NodeKind so that IDs of different node tables don't collide
+ */
+struct TripleKey
+{
+    int64_t s;
+    int64_t p;
+    int64_t o;
+    int64_t c;
+
+    bool operator==(const TripleKey &k) const
+    {
+        return s == k.s && p == k.p && o == k.o && c == k.c;
+    }
+};
+
+static inline TripleKey triple_key(int64_t sId, int sKind, int64_t pUri,
+                                   int64_t oId, int oKind, int64_t cUri)
+{
+    return TripleKey{sId * 4 + sKind, pUri, oId * 4 + oKind, cUri};
+}
+
+static inline uint64_t triple_key_hash(const TripleKey &k)
+{
+    uint64_t h = (uint64_t) k.s;
+    h = h * 0x9E3779B97F4A7C15ULL ^ (uint64_t) k.p;
+    h = h * 0x9E3779B97F4A7C15ULL ^ (uint64_t) k.o;
+    h = h * 0x9E3779B97F4A7C15ULL ^ (uint64_t) k.c;
+    // spread the bits, the bloom filter uses all of them
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+struct TripleKeyHash
+{
+    size_t operator()(const TripleKey &k) const
+    {
+        return (size_t) triple_key_hash(k);
+    }
+};
+
+/**
+ * node IDs resolved ahead for a window of statements being added, see
+ * resolve_window_nodes()
+ */
+struct NodeWindow
+{
+    // IDs by NodeKind, literals are keyed by literal_window_key()
+    std::unordered_map<string, int64_t> ids[NODE_KIND_LITERAL + 1];
+    // IDs of the nodes inserted for the window, by NodeKind
+    std::unordered_set<int64_t> inserted[NODE_KIND_LITERAL + 1];
+    // IDs of the statements inserted while the window is active, so that a
+    // statement repeated in the window isn't inserted twice
+    std::unordered_map<TripleKey, int64_t, TripleKeyHash> statements;
+    bool active;
+
+    NodeWindow() : ids(), inserted(), statements(), active(false)
+    {
+    }
+
+    /** return 0 if the key isn't in the window */
+    int64_t find(NodeKind kind, const string &key) const
+    {
+        auto i = ids[kind].find(key);
+        return i != ids[kind].end() ? i->second : 0;
+    }
+
+    bool isInserted(NodeKind kind, int64_t id) const
+    {
+        return id && inserted[kind].count(id);
+    }
+
+    void clear()
+    {
+        for (unsigned int i = 0; i <= NODE_KIND_LITERAL; ++i) {
+            ids[i].clear();
+            inserted[i].clear();
+        }
+        statements.clear();
+        active = false;
+    }
+};
+
+/** the smallest statement count the bloom filter is sized for */
+static const size_t TRIPLE_FILTER_MIN_CAPACITY = 1 << 20;
+
+/** default idle match statements kept per query shape */
+static const unsigned int MATCH_POOL_SIZE = 4;
+
+/** default seconds after which idle match statements are freed */
+static const unsigned int MATCH_IDLE_SECONDS = 60;
+
 struct Instance
 {
     // prepared statements, lazy initialisation
@@ -57,6 +182,8 @@ struct Instance
 
     DbStatement *getPrepStatement(PrepStatementIndex psi)
     {
+        lastStatement_ = psi;
+        statementCalls_[psi]++;
         PreparedStatement &s = statements_.get(psi);
         if (!s.st) {
             s.st = new DbStatement(std::move(db_.createStatement(s.sql, &tr_)));
@@ -74,7 +201,16 @@ struct Instance
 
         int64_t operator()(const string &s)
         {
+            if (inst_.hashLookup()) {
+                DbStatement *st = inst_.getPrepStatement(GET_RESOURCE_ID_HASH);
+                metrics::ScopedTimer timer = inst_.timeStatement();
+                st->setInt(1, node_hash(s.data(), s.size()));
+                st->setText(2, s.c_str());
+                return st->uniqueResult().getInt64(0);
+            }
+
             DbStatement *st = inst_.getPrepStatement(GET_RESOURCE_ID);
+            metrics::ScopedTimer timer = inst_.timeStatement();
             st->setText(1, s.c_str());
             return st->uniqueResult().getInt64(0);
         }
@@ -82,23 +218,25 @@ struct Instance
             Instance &inst_;
     };
 
-    DbStatement *acquireMatchStatement(unsigned int index, void *userTag,
-                                       const string *sql = nullptr)
+    using PooledStatement = MatchPreparedStatement::PooledStatement;
+
+    /**
+     * take an idle statement of the index pool or prepare sql if there is
+     * none, release it with releaseMatchStatement()
+     */
+    PooledStatement *acquireMatchStatement(unsigned int index,
+                                           const string *sql = nullptr)
     {
-        MatchPreparedStatement &mps = matchStatements_.get(index);
-        MatchPreparedStatement::StatementTagPair *p = nullptr;
-        for (MatchPreparedStatement::StatementTagPair &i : mps.statements) {
-            if (!i.second) {
-                // use statement if available
-                p = &i;
-            } else if (i.second == userTag) {
-                // but prefer the statement of this user
-                p = &i;
-                break;
-            }
-        }
+        evictIdleMatchStatements();
 
-        if (!p) {
+        MatchPreparedStatement &mps = matchStatements_.get(index);
+        PooledStatement *p;
+        if (!mps.idle.empty()) {
+            p = mps.idle.back();
+            mps.idle.pop_back();
+            p->st->reset();
+            mps.reuses++;
+        } else {
             if (!sql) {
                 // no SQL to create a new prepared statement
                 assert(sql);
@@ -107,61 +245,217 @@ struct Instance
 
             DbStatement *st = new DbStatement(std::move(db_.createStatement(
                                                        sql->c_str(), &tr_)));
-            mps.statements.emplace_back(st, userTag);
-            p = &mps.statements.back();
+            p = new PooledStatement{st, std::chrono::steady_clock::now()};
+            mps.prepares++;
             if (mps.sql.empty()) {
                 mps.sql = *sql;
             } else {
                 assert(mps.sql == *sql);
             }
-        } else {
-            assert(p->first);
-            // mark this prepared statement as in use by current user tag
-            p->second = userTag;
-            p->first->reset();
         }
 
-        return p->first;
+        mps.inUse++;
+        mps.peakInUse = std::max(mps.peakInUse, mps.inUse);
+        return p;
     }
 
-    void releaseMatchStatement(unsigned int index, void *userTag)
+    /** return a statement to its pool, or free it if the pool is full */
+    void releaseMatchStatement(unsigned int index, PooledStatement *p)
     {
         MatchPreparedStatement &mps = matchStatements_.get(index);
-        for (MatchPreparedStatement::StatementTagPair &i : mps.statements) {
-            if (i.second == userTag) {
-                i.second = nullptr;
-                return;
+        assert(mps.inUse > 0);
+        mps.inUse--;
+        if (mps.idle.size() < matchPoolSize_) {
+            p->released = std::chrono::steady_clock::now();
+            mps.idle.push_back(p);
+        } else {
+            delete p->st;
+            delete p;
+        }
+    }
+
+    /**
+     * free the statements idle for longer than matchIdleSeconds_, checks
+     * the pools at most once a second; called when acquiring a statement
+     * and after commits, rollbacks and close, so that a storage which stops
+     * matching still frees them
+     */
+    void evictIdleMatchStatements()
+    {
+        if (matchIdleSeconds_ == 0) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastEviction_ < std::chrono::seconds(1)) {
+            return;
+        }
+        lastEviction_ = now;
+
+        const auto oldest = now - std::chrono::seconds(matchIdleSeconds_);
+        for (MatchPreparedStatement &mps : matchStatements_.statements_) {
+            // the least recently released statements are at the front
+            while (!mps.idle.empty() && mps.idle.front()->released < oldest) {
+                delete mps.idle.front()->st;
+                delete mps.idle.front();
+                mps.idle.pop_front();
             }
         }
-        assert(false && "No such user tag for prepared statement!");
     }
 
 
     DbConnection db_;
     DbTransaction tr_;
+    // optional schema features present in the database, see SchemaFlags
+    const unsigned int schemaFlags_;
     GetResourceId getResId_;
     cache::GenericCache<string, int64_t, GetResourceId> resCache;
+    // TRIPLE_COUNT rows added by this connection since TRIPLE_COUNT was
+    // last checked for compaction
+    unsigned int countRows_;
+    // delete unused nodes after removing a context's statements
+    bool removeOrphanNodes_;
+    // in a transaction started by librdf_storage_transaction_start(), the
+    // bulk operations don't commit their batches then
+    bool userTransaction_;
+
+    // connection parameters, for the index statistics connection
+    const string dbName_;
+    const string server_;
+    const string userName_;
+    const string userPassword_;
+    // rows inserted or deleted per table since the statistics of its
+    // indexes were last refreshed
+    uint64_t changedRows_[CHANGED_TABLE_COUNT];
+    // refresh the index statistics of a table when more than this fraction
+    // of its rows changed, 0 disables the refresh
+    double statsFraction_;
+    std::thread statsThread_;
+    std::atomic<bool> statsRunning_;
+    // error of the last background refresh, reported by the next one
+    string statsError_;
+    // fast load mode: the TRIPLE indexes are inactive and find_statement
+    // looks statements up in loadedTriples_ instead of probing TRIPLE
+    bool fastLoad_;
+    // the attachment ID of the fast load's FASTLOAD_STATE marker
+    int64_t fastLoadAttachment_;
+    // statement IDs of the whole TRIPLE table, valid if loadedTriplesValid_
+    std::unordered_map<TripleKey, int64_t, TripleKeyHash> loadedTriples_;
+    bool loadedTriplesValid_;
+    // skip SELECT_TRIPLE probes of statements tripleFilter_ rules out
+    bool useTripleFilter_;
+    cache::BlockedBloomFilter tripleFilter_;
+    bool tripleFilterValid_;
+    // highest statement ID added to tripleFilter_
+    int64_t filterMaxId_;
+    // where tripleFilter_ is loaded from and saved to, may be empty
+    string tripleFilterFile_;
+    // creation time of the database, a snapshot of another one is ignored
+    string databaseId_;
+    // node IDs of the statements being added by pub_context_add_statements
+    NodeWindow nodeWindow_;
+
+    // operation statistics, see librdf_storage_firebird_get_stats(); the
+    // latency histograms are only kept with metricsEnabled_
+    bool metricsEnabled_;
+    PrepStatementIndex lastStatement_;
+    uint64_t statementCalls_[LAST_PREP_STATEMENT_IDX];
+    metrics::OperationStats statementStats_[LAST_PREP_STATEMENT_IDX];
+    // time to the first row and rows fetched per match query shape
+    metrics::OperationStats matchStats_[
+                            MatchPreparedStatements::MATCH_STATEMENTS_COUNT];
+    uint64_t matchRows_[MatchPreparedStatements::MATCH_STATEMENTS_COUNT];
+    metrics::OperationStats decodeStats_;
+    metrics::OperationStats commitStats_;
+    metrics::OperationStats rollbackStats_;
+    // bloom filter lookups and how many of them ruled a statement out
+    uint64_t filterChecks_;
+    uint64_t filterNegatives_;
+    // idle match statements kept per query shape and for how long
+    unsigned int matchPoolSize_;
+    unsigned int matchIdleSeconds_;
+    std::chrono::steady_clock::time_point lastEviction_;
+    // match queries slower than slowQueryMs_ (0 for none) are logged to
+    // slowQueryLog_ or librdf_log, one in slowQuerySample_ queries is timed
+    unsigned int slowQueryMs_;
+    unsigned int slowQuerySample_;
+    uint64_t matchQueries_;
+    FILE *slowQueryLog_;
+    // log the plan of each match query shape when it is first prepared
+    bool explainPlans_;
+    bool explained_[MatchPreparedStatements::MATCH_STATEMENTS_COUNT];
 
     Instance(const char *dbName, const char *server,
              const char *userName, const char *userPassword)
             : db_{dbName, server, userName, userPassword},
               tr_{db_.nativeHandle(), 1},
+              schemaFlags_(get_schema_flags(db_, tr_)),
               getResId_(*this),
-              resCache(getResId_)
+              resCache(getResId_),
+              countRows_(0),
+              removeOrphanNodes_(false),
+              userTransaction_(false),
+              dbName_(dbName),
+              server_(server ? server : ""),
+              userName_(userName ? userName : ""),
+              userPassword_(userPassword ? userPassword : ""),
+              changedRows_(),
+              statsFraction_(0),
+              statsRunning_(false),
+              fastLoad_(false),
+              fastLoadAttachment_(0),
+              loadedTriples_(),
+              loadedTriplesValid_(false),
+              useTripleFilter_(false),
+              tripleFilter_(),
+              tripleFilterValid_(false),
+              filterMaxId_(0),
+              tripleFilterFile_(),
+              databaseId_(),
+              nodeWindow_(),
+              metricsEnabled_(true),
+              lastStatement_(GET_RESOURCE_ID),
+              statementCalls_(),
+              statementStats_(),
+              matchStats_(),
+              matchRows_(),
+              decodeStats_(),
+              commitStats_(),
+              rollbackStats_(),
+              filterChecks_(0),
+              filterNegatives_(0),
+              matchPoolSize_(MATCH_POOL_SIZE),
+              matchIdleSeconds_(MATCH_IDLE_SECONDS),
+              lastEviction_(std::chrono::steady_clock::now()),
+              slowQueryMs_(0),
+              slowQuerySample_(1),
+              matchQueries_(0),
+              slowQueryLog_(nullptr),
+              explainPlans_(false),
+              explained_()
     {
     }
 
     ~Instance()
     {
+        if (statsThread_.joinable()) {
+            statsThread_.join();
+        }
+
+        if (slowQueryLog_) {
+            fclose(slowQueryLog_);
+        }
+
         for (unsigned int i = 0; i != LAST_PREP_STATEMENT_IDX; ++i) {
             PreparedStatement &s = statements_.get((PrepStatementIndex) i);
             delete s.st;
         }
 
         for (MatchPreparedStatement &mps : matchStatements_.statements_) {
-            for (MatchPreparedStatement::StatementTagPair &i : mps.statements) {
-                assert(i.second == nullptr);
-                delete i.first;
+            assert(mps.inUse == 0);
+            for (PooledStatement *p : mps.idle) {
+                delete p->st;
+                delete p;
             }
         }
     }
@@ -170,6 +464,145 @@ struct Instance
     {
         return resCache.getValue(res);
     }
+
+    bool unifiedNodes() const
+    {
+        return (schemaFlags_ & SCHEMA_UNIFIED_NODES) != 0;
+    }
+
+    bool hashLookup() const
+    {
+        return (schemaFlags_ & SCHEMA_HASH_LOOKUP) != 0;
+    }
+
+    bool longLiterals() const
+    {
+        return (schemaFlags_ & SCHEMA_LONG_LITERALS) != 0;
+    }
+
+    bool tripleCount() const
+    {
+        return (schemaFlags_ & SCHEMA_TRIPLE_COUNT) != 0;
+    }
+
+    bool tripleLog() const
+    {
+        return (schemaFlags_ & SCHEMA_TRIPLE_LOG) != 0;
+    }
+
+    /**
+     * the statement IDs of the TRIPLE table keyed by their nodes (fast load
+     * mode), read with one scan on first use
+     */
+    std::unordered_map<TripleKey, int64_t, TripleKeyHash> &loadedTriples()
+    {
+        if (!loadedTriplesValid_) {
+            loadedTriples_.clear();
+            scanTripleKeys(0, [this] (const TripleKey &k, int64_t id) {
+                loadedTriples_.emplace(k, id);
+            });
+            loadedTriplesValid_ = true;
+        }
+        return loadedTriples_;
+    }
+
+    /** call func(key, id) for each statement with an ID above fromId */
+    template<class Func>
+    void scanTripleKeys(int64_t fromId, Func func)
+    {
+        DbStatement *st = getPrepStatement(unifiedNodes() ?
+                                           SCAN_TRIPLE_KEYS_UNIFIED :
+                                           SCAN_TRIPLE_KEYS);
+        st->setInt(1, fromId);
+        for (DbStatement::Iterator i = st->iterate(); i != st->end(); ++i) {
+            fb::DbRowProxy row = *i;
+            TripleKey k = triple_key(row.getInt64(1),
+                                     (int) row.getInt64(2),
+                                     row.getInt64(3),
+                                     row.getInt64(4),
+                                     (int) row.getInt64(5),
+                                     row.fieldIsNull(6) ? 0 : row.getInt64(6));
+            func(k, row.getInt64(0));
+        }
+    }
+
+    /**
+     * the bloom filter over the keys of all statements, built with one scan
+     * of TRIPLE on first use or extended from a snapshot; rebuilt larger once
+     * it holds more keys than it was sized for
+     */
+    cache::BlockedBloomFilter &tripleFilter()
+    {
+        if (tripleFilter_.full() || tripleFilter_.capacity() == 0) {
+            // room for the current statements and as many new ones
+            DbStatement *st = getPrepStatement(GET_TRIPLE_SEQUENCE);
+            const int64_t count = st->uniqueResult().getInt64(0);
+            tripleFilter_ = cache::BlockedBloomFilter(
+                    std::max<size_t>(2 * (size_t) std::max<int64_t>(count, 0),
+                                     TRIPLE_FILTER_MIN_CAPACITY));
+            tripleFilterValid_ = false;
+            filterMaxId_ = 0;
+        }
+        if (!tripleFilterValid_) {
+            scanTripleKeys(filterMaxId_, [this] (const TripleKey &k, int64_t id) {
+                tripleFilter_.add(triple_key_hash(k));
+                filterMaxId_ = std::max(filterMaxId_, id);
+            });
+            tripleFilterValid_ = true;
+        }
+        return tripleFilter_;
+    }
+
+    /** record a new statement in the node window, fast load map and filter */
+    void tripleAdded(const TripleKey &k, int64_t id)
+    {
+        if (nodeWindow_.active) {
+            nodeWindow_.statements.emplace(k, id);
+        }
+        if (fastLoad_) {
+            loadedTriples_.emplace(k, id);
+        }
+        if (useTripleFilter_) {
+            tripleFilter_.add(triple_key_hash(k));
+            filterMaxId_ = std::max(filterMaxId_, id);
+            if (tripleFilter_.full()) {
+                tripleFilterValid_ = false;
+            }
+        }
+    }
+
+    /** forget loadedTriples_ after statements were deleted in bulk */
+    void invalidateLoadedTriples()
+    {
+        loadedTriples_.clear();
+        loadedTriplesValid_ = false;
+    }
+
+    /** time the statement of the last getPrepStatement() call */
+    metrics::ScopedTimer timeStatement()
+    {
+        return time(statementStats_[lastStatement_]);
+    }
+
+    /** time an operation until the end of the scope */
+    metrics::ScopedTimer time(metrics::OperationStats &stats)
+    {
+        return metrics::ScopedTimer(metricsEnabled_ ? &stats.histogram() :
+                                                      nullptr);
+    }
+
+    /** whether to trace the next match query for the slow query log */
+    bool traceMatchQuery()
+    {
+        return slowQueryMs_ != 0 && matchQueries_++ % slowQuerySample_ == 0;
+    }
+
+    /** count statements added to or deleted from TRIPLE */
+    void triplesChanged(unsigned int count)
+    {
+        countRows_ += count;
+        changedRows_[CHANGED_TRIPLE] += count;
+    }
 };
 
 static inline Instance *get_instance(librdf_storage *storage)
@@ -207,6 +640,7 @@ enum idx_triple_column_t : int
     IDX_O_LANGUAGE,
     IDX_O_DATATYPE,
     IDX_C_URI,
+    IDX_O_LONG_LITERAL,
     IDX_STATEMENT_COUNT
 };
 
@@ -214,13 +648,33 @@ enum idx_triple_column_t : int
 static int64_t get_resource_id(librdf_storage *storage, const char *uri)
 {
     Instance *ctx = get_instance(storage);
+    if (ctx->nodeWindow_.active) {
+        const int64_t id = ctx->nodeWindow_.find(NODE_KIND_RESOURCE, uri);
+        if (id) {
+            return id;
+        }
+    }
     return ctx->getResourceId(uri);
 }
 
 static int64_t add_resource(librdf_storage *storage, const char *uri)
 {
     Instance *ctx = get_instance(storage);
-    DbStatement *st = ctx->getPrepStatement(INSERT_RESOURCE);
+    ctx->changedRows_[CHANGED_RESOURCE]++;
+    if (ctx->hashLookup()) {
+        DbStatement *st = ctx->getPrepStatement(ctx->unifiedNodes() ?
+                                                INSERT_RESOURCE_UNIFIED_HASH :
+                                                INSERT_RESOURCE_HASH);
+        metrics::ScopedTimer timer = ctx->timeStatement();
+        st->setText(1, uri);
+        st->setInt(2, node_hash(uri));
+        return st->uniqueResult().getInt64(0);
+    }
+
+    DbStatement *st = ctx->getPrepStatement(ctx->unifiedNodes() ?
+                                            INSERT_RESOURCE_UNIFIED :
+                                            INSERT_RESOURCE);
+    metrics::ScopedTimer timer = ctx->timeStatement();
     st->setText(1, uri);
     return st->uniqueResult().getInt64(0);
 }
@@ -229,6 +683,7 @@ static int64_t get_context_id(librdf_storage *storage, const char *uri)
 {
     Instance *ctx = get_instance(storage);
     DbStatement *st = ctx->getPrepStatement(GET_CONTEXT_ID);
+    metrics::ScopedTimer timer = ctx->timeStatement();
     st->setText(1, uri);
     return st->uniqueResult().getInt64(0);
 }
@@ -236,7 +691,9 @@ static int64_t get_context_id(librdf_storage *storage, const char *uri)
 static int64_t add_context(librdf_storage *storage, const char *uri)
 {
     Instance *ctx = get_instance(storage);
+    ctx->changedRows_[CHANGED_CONTEXT]++;
     DbStatement *st = ctx->getPrepStatement(INSERT_CONTEXT);
+    metrics::ScopedTimer timer = ctx->timeStatement();
     st->setText(1, uri);
     return st->uniqueResult().getInt64(0);
 }
@@ -244,7 +701,14 @@ static int64_t add_context(librdf_storage *storage, const char *uri)
 static int64_t get_blank_id(librdf_storage *storage, const char *blank)
 {
     Instance *ctx = get_instance(storage);
+    if (ctx->nodeWindow_.active) {
+        const int64_t id = ctx->nodeWindow_.find(NODE_KIND_BLANK, blank);
+        if (id) {
+            return id;
+        }
+    }
     DbStatement *st = ctx->getPrepStatement(GET_BNODE_ID);
+    metrics::ScopedTimer timer = ctx->timeStatement();
     st->setText(1, blank);
     return st->uniqueResult().getInt64(0);
 }
@@ -252,28 +716,92 @@ static int64_t get_blank_id(librdf_storage *storage, const char *blank)
 static int64_t add_blank(librdf_storage *storage, const char *blank)
 {
     Instance *ctx = get_instance(storage);
-    DbStatement *st = ctx->getPrepStatement(INSERT_BNODE);
+    ctx->changedRows_[CHANGED_BNODE]++;
+    DbStatement *st = ctx->getPrepStatement(ctx->unifiedNodes() ?
+                                            INSERT_BNODE_UNIFIED :
+                                            INSERT_BNODE);
+    metrics::ScopedTimer timer = ctx->timeStatement();
     st->setText(1, blank);
     return st->uniqueResult().getInt64(0);
 }
 
+/**
+ * Bind the literal value (preceded by its hash if the database has
+ * SCHEMA_HASH_LOOKUP) and return the index of the next parameter.
+ */
+static unsigned int bind_literal_value(Instance *ctx, DbStatement *st,
+                                       const char *literal)
+{
+    unsigned int n = 1;
+    if (ctx->hashLookup()) {
+        st->setInt(n++, node_hash(literal));
+    }
+    st->setText(n++, literal);
+    return n;
+}
+
+/**
+ * Return true if the literal doesn't fit in LITERAL.VAL and is stored in
+ * LITERAL.VAL_BLOB instead (SCHEMA_LONG_LITERALS).
+ */
+static inline bool is_long_literal(Instance *ctx, const char *literal)
+{
+    return ctx->longLiterals() && strlen(literal) > INLINE_LITERAL_LENGTH;
+}
+
+/** key of a literal in NodeWindow */
+static string literal_window_key(const char *literal, const char *lang,
+                                 const char *datatype)
+{
+    string key = literal;
+    key += '\x01';
+    if (lang) {
+        key += lang;
+    }
+    key += '\x01';
+    if (datatype) {
+        key += datatype;
+    }
+    return key;
+}
+
 static int64_t get_literal_id(librdf_storage *storage, const char *literal,
                             const char *lang, const char *datatype)
 {
     assert(literal);
     assert((!lang && !datatype) || (lang != nullptr) != (datatype != nullptr));
     Instance *ctx = get_instance(storage);
+    if (ctx->nodeWindow_.active) {
+        const int64_t id = ctx->nodeWindow_.find(NODE_KIND_LITERAL,
+                                literal_window_key(literal, lang, datatype));
+        if (id) {
+            return id;
+        }
+    }
+    const bool hashed = ctx->hashLookup();
+    const bool isLong = is_long_literal(ctx, literal);
+    if (isLong && strlen(literal) > LONG_LITERAL_LENGTH) {
+        // can't have been stored
+        return 0;
+    }
 
     if (!lang && !datatype) {
-        DbStatement *st = ctx->getPrepStatement(GET_LITERAL_ID_1);
-        st->setText(1, literal);
+        DbStatement *st = ctx->getPrepStatement(
+                                        isLong ? GET_LONG_LITERAL_ID_1 :
+                                        hashed ? GET_LITERAL_ID_1_HASH :
+                                                 GET_LITERAL_ID_1);
+        metrics::ScopedTimer timer = ctx->timeStatement();
+        bind_literal_value(ctx, st, literal);
         return st->uniqueResult().getInt64(0);
     }
 
     if (lang) {
-        DbStatement *st = ctx->getPrepStatement(GET_LITERAL_ID_2_LANG);
-        st->setText(1, literal);
-        st->setText(2, lang);
+        DbStatement *st = ctx->getPrepStatement(
+                                        isLong ? GET_LONG_LITERAL_ID_2_LANG :
+                                        hashed ? GET_LITERAL_ID_2_LANG_HASH :
+                                                 GET_LITERAL_ID_2_LANG);
+        metrics::ScopedTimer timer = ctx->timeStatement();
+        st->setText(bind_literal_value(ctx, st, literal), lang);
         return st->uniqueResult().getInt64(0);
     }
 
@@ -287,18 +815,30 @@ static int64_t get_literal_id(librdf_storage *storage, const char *literal,
         return 0;
     }
 
-    DbStatement *st = ctx->getPrepStatement(GET_LITERAL_ID_3_DT);
-    st->setText(1, literal);
-    st->setInt(2, dtId);
+    DbStatement *st = ctx->getPrepStatement(isLong ? GET_LONG_LITERAL_ID_3_DT :
+                                            hashed ? GET_LITERAL_ID_3_DT_HASH :
+                                                     GET_LITERAL_ID_3_DT);
+    metrics::ScopedTimer timer = ctx->timeStatement();
+    st->setInt(bind_literal_value(ctx, st, literal), dtId);
     return st->uniqueResult().getInt64(0);
 }
 
+/** return 0 if the literal is too long to be stored */
 static int64_t add_literal(librdf_storage *storage, const char *literal,
                             const char *lang, const char *datatype)
 {
     assert(literal);
     assert((!lang && !datatype) || (lang != nullptr) != (datatype != nullptr));
 
+    Instance *ctx = get_instance(storage);
+    const bool isLong = is_long_literal(ctx, literal);
+    if (isLong && strlen(literal) > LONG_LITERAL_LENGTH) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE,
+                   NULL, "Literal too long: %u bytes",
+                   (unsigned int) strlen(literal));
+        return 0;
+    }
+
     int64_t dtId = 0;
     if (datatype) {
         dtId = get_resource_id(storage, datatype);
@@ -307,8 +847,24 @@ static int64_t add_literal(librdf_storage *storage, const char *literal,
         }
     }
 
-    Instance *ctx = get_instance(storage);
-    DbStatement *st = ctx->getPrepStatement(INSERT_LITERAL);
+    ctx->changedRows_[CHANGED_LITERAL]++;
+    DbStatement *st;
+    if (isLong) {
+        st = ctx->getPrepStatement(ctx->unifiedNodes() ?
+                                   INSERT_LONG_LITERAL_UNIFIED :
+                                   INSERT_LONG_LITERAL);
+        st->setInt(4, node_hash(literal));
+    } else if (ctx->hashLookup()) {
+        st = ctx->getPrepStatement(ctx->unifiedNodes() ?
+                                   INSERT_LITERAL_UNIFIED_HASH :
+                                   INSERT_LITERAL_HASH);
+        st->setInt(4, node_hash(literal));
+    } else {
+        st = ctx->getPrepStatement(ctx->unifiedNodes() ?
+                                   INSERT_LITERAL_UNIFIED :
+                                   INSERT_LITERAL);
+    }
+    metrics::ScopedTimer timer = ctx->timeStatement();
     st->setText(1, literal);
     st->setText(2, lang);
     if (dtId) {
@@ -344,134 +900,110 @@ static int64_t get_context_node_id(librdf_storage *storage,
     return node_id;
 }
 
+/** return false for nodes which are neither resources, blanks nor literals */
+static bool node_term(librdf_node *node, NodeTerm &term)
+{
+    size_t len = 0;
+    term.lang = nullptr;
+    term.datatype = nullptr;
+    switch (node_type(node)) {
+    case LIBRDF_NODE_TYPE_RESOURCE:
+        term.kind = NODE_KIND_RESOURCE;
+        term.value = (const char*) librdf_uri_as_counted_string(
+                                        librdf_node_get_uri(node), &len);
+        return true;
+    case LIBRDF_NODE_TYPE_BLANK:
+        term.kind = NODE_KIND_BLANK;
+        term.value = (const char*)
+                    librdf_node_get_counted_blank_identifier(node, &len);
+        return true;
+    case LIBRDF_NODE_TYPE_LITERAL:
+    {
+        term.kind = NODE_KIND_LITERAL;
+        term.value = (const char*)
+                librdf_node_get_literal_value_as_counted_string(node, &len);
+        term.lang = librdf_node_get_literal_value_language(node);
+        librdf_uri *dt = librdf_node_get_literal_value_datatype_uri(node);
+        term.datatype = dt ? (const char*) librdf_uri_as_string(dt) : nullptr;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
 /**
- * \return 0 if not found or the statement ID otherwise
- * \param context_node_id should be != 0 if a context node exists
+ * Return the ID of a node or 0 if it doesn't exist and !create. With create
+ * missing nodes are inserted and counted in insertedNodes, 0 is only
+ * returned for literals too long to be stored.
  */
-static int64_t find_statement(librdf_storage *storage,
-                              int64_t context_node_id,
-                              librdf_statement *statement,
-                              bool create)
+static int64_t get_node_id(librdf_storage *storage, const NodeTerm &term,
+                           bool create, int &insertedNodes)
 {
-    librdf_node *s = librdf_statement_get_subject(statement);
-    librdf_node *p = librdf_statement_get_predicate(statement);
-    librdf_node *o = librdf_statement_get_object(statement);
-
-    int64_t sUri = 0;
-    int64_t sBlank = 0;
-    int64_t pUri = 0;
-    int64_t oUri = 0;
-    int64_t oBlank = 0;
-    int64_t oLiteral = 0;
-    int64_t cUri = 0;
-    int insertedNodes = 0;
-
-    const unsigned char *str;
-    size_t len;
-
-    if (node_type(s) == LIBRDF_NODE_TYPE_RESOURCE) {
-        len = 0;
-        str = librdf_uri_as_counted_string(librdf_node_get_uri(s), &len);
-
-        sUri = get_resource_id(storage, (const char*) str);
-        if (sUri == 0) {
-            if (!create) {
-                return 0;
-            } else {
-                sUri = add_resource(storage, (const char*) str);
-                insertedNodes++;
-            }
+    int64_t id = 0;
+    switch (term.kind) {
+    case NODE_KIND_RESOURCE:
+        id = get_resource_id(storage, term.value);
+        if (id == 0 && create) {
+            id = add_resource(storage, term.value);
+            insertedNodes++;
         }
-    } else if (node_type(s) == LIBRDF_NODE_TYPE_BLANK) {
-        len = 0;
-        str = librdf_node_get_counted_blank_identifier(s, &len);
-        sBlank = get_blank_id(storage, (const char*) str);
-        if (sBlank == 0) {
-            if (!create) {
-                return 0;
-            } else {
-                sBlank = add_blank(storage, (const char*) str);
+        break;
+    case NODE_KIND_BLANK:
+        id = get_blank_id(storage, term.value);
+        if (id == 0 && create) {
+            id = add_blank(storage, term.value);
+            insertedNodes++;
+        }
+        break;
+    case NODE_KIND_LITERAL:
+        id = get_literal_id(storage, term.value, term.lang, term.datatype);
+        if (id == 0 && create) {
+            id = add_literal(storage, term.value, term.lang, term.datatype);
+            if (id != 0) {
                 insertedNodes++;
             }
         }
-    } else {
-        assert(false);
-        return 0;
+        break;
     }
+    return id;
+}
 
-    if (node_type(p) == LIBRDF_NODE_TYPE_RESOURCE) {
-        len = 0;
-        str = librdf_uri_as_counted_string(librdf_node_get_uri(p), &len);
+/**
+ * \return 0 if not found or the statement ID otherwise
+ * \param context_node_id should be != 0 if a context node exists
+ * \param key if not null receives the statement's key in fast load mode
+ */
+static int64_t find_statement_terms(librdf_storage *storage,
+                                    int64_t context_node_id,
+                                    const NodeTerm &s, const NodeTerm &p,
+                                    const NodeTerm &o, bool create,
+                                    TripleKey *key = nullptr)
+{
+    assert(s.kind != NODE_KIND_LITERAL && p.kind == NODE_KIND_RESOURCE);
 
-        pUri = get_resource_id(storage, (const char*) str);
-        if (pUri == 0) {
-            if (!create) {
-                return 0;
-            } else {
-                pUri = add_resource(storage, (const char*) str);
-                insertedNodes++;
-            }
-        }
-    } else {
-        assert(false);
+    int insertedNodes = 0;
+    const int64_t sId = get_node_id(storage, s, create, insertedNodes);
+    if (sId == 0) {
         return 0;
     }
-
-    if (node_type(o) == LIBRDF_NODE_TYPE_RESOURCE) {
-        len = 0;
-        str = librdf_uri_as_counted_string(librdf_node_get_uri(o), &len);
-
-        oUri = get_resource_id(storage, (const char*) str);
-        if (oUri == 0) {
-            if (!create) {
-                return 0;
-            } else {
-                oUri = add_resource(storage, (const char*) str);
-                insertedNodes++;
-            }
-        }
-    } else if (node_type(o) == LIBRDF_NODE_TYPE_BLANK) {
-        len = 0;
-        str = librdf_node_get_counted_blank_identifier(o, &len);
-        oBlank = get_blank_id(storage, (const char*) str);
-        if (oBlank == 0) {
-            if (!create) {
-                return 0;
-            } else {
-                oBlank = add_blank(storage, (const char*) str);
-                insertedNodes++;
-            }
-        }
-    } else if (node_type(o) == LIBRDF_NODE_TYPE_LITERAL) {
-        len = 0;
-        str = librdf_node_get_literal_value_as_counted_string(o, &len);
-        const unsigned char *dtUri = nullptr;
-        librdf_uri *uri = librdf_node_get_literal_value_datatype_uri(o);
-        if (uri) {
-            len = 0;
-            dtUri = librdf_uri_as_counted_string(uri, &len);
-        }
-        const char *l = librdf_node_get_literal_value_language(o);
-        oLiteral = get_literal_id(storage, (const char*) str, l,
-                                 (const char*) dtUri);
-        if (oLiteral == 0) {
-            if (!create) {
-                return 0;
-            } else {
-                oLiteral = add_literal(storage, (const char*) str, l,
-                                       (const char*) dtUri);
-                insertedNodes++;
-            }
-        }
-    } else {
-        assert(false);
+    const int64_t pId = get_node_id(storage, p, create, insertedNodes);
+    if (pId == 0) {
         return 0;
     }
-
-    if (context_node_id != 0) {
-        cUri = context_node_id;
+    const int64_t oId = get_node_id(storage, o, create, insertedNodes);
+    if (oId == 0) {
+        return 0;
     }
 
+    const int64_t sUri = s.kind == NODE_KIND_RESOURCE ? sId : 0;
+    const int64_t sBlank = s.kind == NODE_KIND_BLANK ? sId : 0;
+    const int64_t pUri = pId;
+    const int64_t oUri = o.kind == NODE_KIND_RESOURCE ? oId : 0;
+    const int64_t oBlank = o.kind == NODE_KIND_BLANK ? oId : 0;
+    const int64_t oLiteral = o.kind == NODE_KIND_LITERAL ? oId : 0;
+    const int64_t cUri = context_node_id;
+
     /*
      There are 12 possible queries:
     +------+--------+------+--------+----------+------+
@@ -508,24 +1040,116 @@ static int64_t find_statement(librdf_storage *storage,
     Instance *ctx = get_instance(storage);
     DbStatement *st;
 
-    if (insertedNodes == 0) {
+    const TripleKey k = triple_key(sUri ? sUri : sBlank,
+                                   sUri ? NODE_KIND_RESOURCE : NODE_KIND_BLANK,
+                                   pUri,
+                                   oUri ? oUri : (oBlank ? oBlank : oLiteral),
+                                   oUri ? NODE_KIND_RESOURCE :
+                                          (oBlank ? NODE_KIND_BLANK :
+                                                    NODE_KIND_LITERAL),
+                                   cUri);
+    if (key) {
+        *key = k;
+    }
 
-        int64_t sId = 0;
-        int64_t oId = 0;
+    const NodeWindow &window = ctx->nodeWindow_;
+    if (window.active) {
+        auto w = window.statements.find(k);
+        if (w != window.statements.end()) {
+            // added earlier in this window
+            return w->second;
+        }
+        if (insertedNodes == 0 &&
+                (window.isInserted(NODE_KIND_RESOURCE, sUri) ||
+                 window.isInserted(NODE_KIND_BLANK, sBlank) ||
+                 window.isInserted(NODE_KIND_RESOURCE, pUri) ||
+                 window.isInserted(NODE_KIND_RESOURCE, oUri) ||
+                 window.isInserted(NODE_KIND_BLANK, oBlank) ||
+                 window.isInserted(NODE_KIND_LITERAL, oLiteral))) {
+            // a node was inserted for this window and the statement isn't
+            // one added earlier in it, so it is new
+            insertedNodes++;
+        }
+    }
 
-        // compute query index from a 2 * 3 * 2 branching
-        int qindex = 0;
-        int range = 12; // 12 = 2 * 3 * 2
+    if (ctx->fastLoad_) {
+        // the TRIPLE indexes are inactive, look the statement up in memory
+        auto i = ctx->loadedTriples().find(k);
+        if (i != ctx->loadedTriples_.end()) {
+            return i->second;
+        } else if (!create) {
+            return 0;
+        }
+        // skip the SELECT_TRIPLE probes below
+        insertedNodes++;
+    } else if (ctx->useTripleFilter_ && insertedNodes == 0) {
+        ctx->filterChecks_++;
+        if (!ctx->tripleFilter().mayContain(triple_key_hash(k))) {
+            // definitely a new statement
+            ctx->filterNegatives_++;
+            if (!create) {
+                return 0;
+            }
+            insertedNodes++;
+        }
+    }
+
+    if (ctx->unifiedNodes()) {
+        // node IDs are unique across the node tables, the two queries below
+        // replace the 12 above
+        if (insertedNodes == 0) {
+            st = ctx->getPrepStatement(cUri ? SELECT_TRIPLE_UNIFIED_0 :
+                                              SELECT_TRIPLE_UNIFIED_1);
+            metrics::ScopedTimer timer = ctx->timeStatement();
+            st->setInt(1, sId);
+            st->setInt(2, pUri);
+            st->setInt(3, oId);
+            if (cUri) {
+                st->setInt(4, cUri);
+            }
+
+            int64_t stId = st->uniqueResult().getInt64(0);
+            if (stId != 0) {
+                // statement already exists
+                return stId;
+            }
+        } else {
+            assert(create);
+        }
+
+        ctx->triplesChanged(1);
+        st = ctx->getPrepStatement(INSERT_TRIPLE_UNIFIED);
+        metrics::ScopedTimer timer = ctx->timeStatement();
+        st->setInt(1, sId);
+        st->setInt(2, sUri ? NODE_KIND_RESOURCE : NODE_KIND_BLANK);
+        st->setInt(3, pUri);
+        st->setInt(4, oId);
+        st->setInt(5, oUri ? NODE_KIND_RESOURCE :
+                             (oBlank ? NODE_KIND_BLANK : NODE_KIND_LITERAL));
+        if (cUri) {
+            st->setInt(6, cUri);
+        } else {
+            st->setNull(6);
+        }
+
+        const int64_t stId = st->uniqueResult().getInt64(0);
+        ctx->tripleAdded(k, stId);
+        return stId;
+    }
+
+    if (insertedNodes == 0) {
+
+        // compute query index from a 2 * 3 * 2 branching
+        int qindex = 0;
+        int range = 12; // 12 = 2 * 3 * 2
         // string query = "SELECT r.ID FROM TRIPLE r WHERE ";
 
         range /= 2; // account for two fold branching
         if (sUri) {
             // query += "r.S_URI=? ";
-            sId = sUri;
             qindex += (0 * range);
         } else {
             // query += "r.S_BLANK=? ";
-            sId = sBlank;
             qindex += (1 * range);
         }
 
@@ -534,15 +1158,12 @@ static int64_t find_statement(librdf_storage *storage,
         range /= 3; // account for three fold branching
         if (oUri) {
             // query += "AND r.O_URI=? ";
-            oId = oUri;
             qindex += (0 * range);
         } else if (oBlank) {
             // query += "AND r.O_BLANK=? ";
-            oId = oBlank;
             qindex += (1 * range);
         } else {
             // query += "AND r.O_LITERAL=? ";
-            oId = oLiteral;
             qindex += (2 * range);
         }
 
@@ -557,8 +1178,11 @@ static int64_t find_statement(librdf_storage *storage,
         }
 
         assert(0 <= qindex && qindex < 12);
-        st = ctx->getPrepStatement(
-                            (PrepStatementIndex) (SELECT_TRIPLE_0 + qindex));
+        const PrepStatementIndex firstQuery =
+                        (ctx->schemaFlags_ & SCHEMA_COMPOSITE_INDEXES) ?
+                                SELECT_TRIPLE_SPOC_0 : SELECT_TRIPLE_0;
+        st = ctx->getPrepStatement((PrepStatementIndex) (firstQuery + qindex));
+        metrics::ScopedTimer timer = ctx->timeStatement();
 
         st->setInt(1, sId);
         st->setInt(2, pUri);
@@ -576,7 +1200,9 @@ static int64_t find_statement(librdf_storage *storage,
         assert(create);
     }
 
+    ctx->triplesChanged(1);
     st = ctx->getPrepStatement(INSERT_TRIPLE);
+    metrics::ScopedTimer timer = ctx->timeStatement();
     if (sUri) {
         st->setInt(1, sUri);
     } else {
@@ -615,9 +1241,458 @@ static int64_t find_statement(librdf_storage *storage,
         st->setNull(7);
     }
 
+    const int64_t stId = st->uniqueResult().getInt64(0);
+    ctx->tripleAdded(k, stId);
+    return stId;
+}
+
+/** find_statement_terms() for a librdf statement */
+static int64_t find_statement(librdf_storage *storage,
+                              int64_t context_node_id,
+                              librdf_statement *statement,
+                              bool create,
+                              TripleKey *key = nullptr)
+{
+    NodeTerm s, p, o;
+    if (!node_term(librdf_statement_get_subject(statement), s) ||
+            !node_term(librdf_statement_get_predicate(statement), p) ||
+            !node_term(librdf_statement_get_object(statement), o) ||
+            s.kind == NODE_KIND_LITERAL || p.kind != NODE_KIND_RESOURCE) {
+        assert(false);
+        return 0;
+    }
+    return find_statement_terms(storage, context_node_id, s, p, o, create,
+                                key);
+}
+
+/**
+ * Compact TRIPLE_COUNT before committing once it has enough rows, whichever
+ * connections added them. It is only checked by connections which changed
+ * TRIPLE since their last check. Failing to compact (e.g. on a conflict
+ * with a concurrent compaction) doesn't prevent the commit.
+ */
+static const unsigned int TRIPLE_COUNT_COMPACT_ROWS = 10000;
+
+static void compact_triple_count_if_needed(librdf_storage *storage)
+{
+    Instance *inst = get_instance(storage);
+    if (!inst->tripleCount() || inst->countRows_ == 0) {
+        return;
+    }
+
+    try {
+        DbStatement *st = inst->getPrepStatement(GET_TRIPLE_COUNT_ROWS);
+        st->setInt(1, (int64_t) TRIPLE_COUNT_COMPACT_ROWS);
+        if (st->uniqueResult().getInt64(0) >= TRIPLE_COUNT_COMPACT_ROWS) {
+            compact_triple_count(inst->db_, inst->tr_);
+        }
+        inst->countRows_ = 0;
+    } catch (std::exception &e) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Failed to compact triple count: %s", e.what());
+    }
+}
+
+/** a node table and the condition telling that its row n is unused */
+struct OrphanNodeTable
+{
+    const char *table;
+    ChangedTable changed;
+    // selected into the result of delete_orphan_window(), for the cache
+    const char *cachedKey;
+    const char *orphanCond;
+    const char *orphanCondUnified;
+    // and that no logged change refers to it (SCHEMA_TRIPLE_LOG)
+    const char *unloggedCond;
+};
+
+// literals refer to their datatype resource, collect them first
+static const OrphanNodeTable orphan_node_tables[] = {
+    {
+        "LITERAL",
+        CHANGED_LITERAL,
+        "NULL",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.O_LITERAL = n.ID)",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.O_ID = n.ID)",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE_LOG g "
+        "WHERE g.O_ID = n.ID AND g.O_KIND = 3)"
+    },
+    {
+        "BNODE",
+        CHANGED_BNODE,
+        "NULL",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.S_BLANK = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.O_BLANK = n.ID)",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.S_ID = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.O_ID = n.ID)",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE_LOG g "
+        "WHERE g.S_ID = n.ID AND g.S_KIND = 2) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE_LOG g "
+        "WHERE g.O_ID = n.ID AND g.O_KIND = 2)"
+    },
+    {
+        "RESOURCE",
+        CHANGED_RESOURCE,
+        "n.URI",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.S_URI = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.P_URI = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.O_URI = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM LITERAL l WHERE l.DATATYPE = n.ID)",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.S_ID = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.P_URI = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE r WHERE r.O_ID = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM LITERAL l WHERE l.DATATYPE = n.ID)",
+        "NOT EXISTS (SELECT 1 FROM TRIPLE_LOG g "
+        "WHERE g.S_ID = n.ID AND g.S_KIND = 1) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE_LOG g WHERE g.P_URI = n.ID) "
+        "AND NOT EXISTS (SELECT 1 FROM TRIPLE_LOG g "
+        "WHERE g.O_ID = n.ID AND g.O_KIND = 1)"
+    }
+};
+
+/**
+ * Return the largest of the next count IDs of a node table after lastId, 0
+ * if there are no more.
+ */
+static int64_t next_node_window(Instance *ctx, const OrphanNodeTable &t,
+                                int64_t lastId, unsigned int count)
+{
+    string q = "SELECT MAX(ID) FROM (SELECT FIRST ? ID FROM ";
+    q += t.table;
+    q += " WHERE ID > ? ORDER BY ID)";
+    DbStatement st = ctx->db_.createStatement(q.c_str(), &ctx->tr_);
+    st.setInt(1, count);
+    st.setInt(2, lastId);
+    return st.uniqueResult().getInt64(0);
+}
+
+/**
+ * Delete the unused nodes of a table with lowId < ID <= highId and return
+ * their number. The rows deleted through the cursor are exactly the rows
+ * returned, so the cache only forgets what was deleted.
+ */
+static int64_t delete_orphan_window(Instance *ctx, const OrphanNodeTable &t,
+                                    int64_t lowId, int64_t highId)
+{
+    string q = "EXECUTE BLOCK (LO BIGINT = ?, HI BIGINT = ?)\n"
+               "RETURNS (NODE_ID BIGINT, NODE_KEY VARCHAR(1024)) AS\n"
+               "BEGIN\n"
+               "    FOR SELECT n.ID, ";
+    q += t.cachedKey;
+    q += " FROM ";
+    q += t.table;
+    q += " n\n        WHERE n.ID > :LO AND n.ID <= :HI AND ";
+    q += ctx->unifiedNodes() ? t.orphanCondUnified : t.orphanCond;
+    if (ctx->tripleLog()) {
+        q += " AND ";
+        q += t.unloggedCond;
+    }
+    q += "\n        INTO :NODE_ID, :NODE_KEY AS CURSOR C DO\n"
+         "    BEGIN\n"
+         "        DELETE FROM ";
+    q += t.table;
+    q += " WHERE CURRENT OF C;\n"
+         "        SUSPEND;\n"
+         "    END\n"
+         "END";
+
+    DbStatement st = ctx->db_.createStatement(q.c_str(), &ctx->tr_);
+    st.setInt(1, lowId);
+    st.setInt(2, highId);
+
+    int64_t deleted = 0;
+    for (DbStatement::Iterator i = st.iterate(); i != st.end(); ++i) {
+        fb::DbRowProxy row = *i;
+        if (!row.fieldIsNull(1)) {
+            ctx->resCache.remove(row.getText(1));
+        }
+        deleted++;
+    }
+    ctx->changedRows_[t.changed] += deleted;
+    return deleted;
+}
+
+/**
+ * Garbage collect unused nodes: examine up to maxNodes IDs of each node
+ * table, continuing where the previous run stopped (NODE_GC_STATE), and
+ * delete the nodes no statement refers to. Return the number of deleted
+ * nodes.
+ */
+static int64_t collect_orphan_nodes(librdf_storage *storage,
+                                    unsigned int maxNodes)
+{
+    Instance *ctx = get_instance(storage);
+    int64_t deleted = 0;
+
+    for (const OrphanNodeTable &t : orphan_node_tables) {
+        DbStatement *st = ctx->getPrepStatement(GET_NODE_GC_POSITION);
+        st->setText(1, t.table);
+        const int64_t lastId = st->uniqueResult().getInt64(0);
+
+        // start over once the end of the table was reached
+        int64_t highId = next_node_window(ctx, t, lastId, maxNodes);
+        if (highId != 0) {
+            deleted += delete_orphan_window(ctx, t, lastId, highId);
+        }
+
+        st = ctx->getPrepStatement(SET_NODE_GC_POSITION);
+        st->setText(1, t.table);
+        st->setInt(2, highId);
+        st->execute();
+    }
+
+    return deleted;
+}
+
+/**
+ * Delete the nodes and contexts which aren't used by any statement, going
+ * through the node tables in windows of IDs.
+ */
+static void delete_orphan_nodes(librdf_storage *storage)
+{
+    static const unsigned int ORPHAN_WINDOW = 10000;
+    Instance *ctx = get_instance(storage);
+
+    ctx->getPrepStatement(ctx->tripleLog() ? DELETE_ORPHAN_CONTEXTS_LOGGED :
+                                             DELETE_ORPHAN_CONTEXTS)->execute();
+    for (const OrphanNodeTable &t : orphan_node_tables) {
+        int64_t lowId = 0;
+        int64_t highId;
+        while ((highId = next_node_window(ctx, t, lowId, ORPHAN_WINDOW))) {
+            delete_orphan_window(ctx, t, lowId, highId);
+            lowId = highId;
+        }
+    }
+}
+
+/**
+ * Bloom filter snapshot layout, in native byte order: the magic string,
+ * the schema flags and the length and text of the database identity it was
+ * taken of, the highest statement ID in the filter, its capacity, item
+ * count and word count followed by the words.
+ */
+static const char TRIPLE_FILTER_MAGIC[8] = {'R', 'D', 'F', 'B', 'L', 'M', '0', '2'};
+
+/**
+ * Load the bloom filter snapshot saved by save_triple_filter(), the
+ * statements added since are scanned on first use. Missing or invalid
+ * snapshots are ignored, as are those of another database or schema layout
+ * (node IDs were renumbered by the unified migration) and those with
+ * statement IDs the database hasn't handed out (a restored or recreated
+ * database), since they could rule out existing statements; the filter is
+ * then built from TRIPLE.
+ */
+static void load_triple_filter(librdf_storage *storage)
+{
+    Instance *inst = get_instance(storage);
+    std::unique_ptr<FILE, decltype(&fclose)> f(
+                        fopen(inst->tripleFilterFile_.c_str(), "rb"), &fclose);
+    if (!f) {
+        return;
+    }
+
+    char magic[sizeof(TRIPLE_FILTER_MAGIC)];
+    uint64_t identity[2] = {0, 0}; // schema flags, database ID length
+    string databaseId;
+    int64_t maxId = 0;
+    uint64_t header[3] = {0, 0, 0}; // capacity, items, word count
+    if (fread(magic, sizeof(magic), 1, f.get()) != 1 ||
+            memcmp(magic, TRIPLE_FILTER_MAGIC, sizeof(magic)) != 0 ||
+            fread(identity, sizeof(identity), 1, f.get()) != 1 ||
+            identity[1] > 256) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Ignoring invalid bloom filter snapshot %s",
+                   inst->tripleFilterFile_.c_str());
+        return;
+    }
+    databaseId.resize(identity[1]);
+    if ((identity[1] &&
+                fread(&databaseId[0], identity[1], 1, f.get()) != 1) ||
+            fread(&maxId, sizeof(maxId), 1, f.get()) != 1 ||
+            fread(header, sizeof(header), 1, f.get()) != 1 ||
+            header[2] == 0 ||
+            header[2] % cache::BlockedBloomFilter::BLOCK_WORDS != 0) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Ignoring invalid bloom filter snapshot %s",
+                   inst->tripleFilterFile_.c_str());
+        return;
+    }
+
+    const int64_t lastId =
+            inst->getPrepStatement(GET_TRIPLE_SEQUENCE)->uniqueResult()
+                                                       .getInt64(0);
+    if (identity[0] != inst->schemaFlags_ ||
+            databaseId != inst->databaseId_ || maxId < 0 || maxId > lastId) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Ignoring bloom filter snapshot %s of another "
+                   "database or schema", inst->tripleFilterFile_.c_str());
+        return;
+    }
+
+    std::vector<uint64_t> words(header[2]);
+    if (fread(words.data(), sizeof(uint64_t), words.size(), f.get()) !=
+            words.size()) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Ignoring truncated bloom filter snapshot %s",
+                   inst->tripleFilterFile_.c_str());
+        return;
+    }
+
+    inst->tripleFilter_ = cache::BlockedBloomFilter(header[0], header[1],
+                                                    std::move(words));
+    inst->filterMaxId_ = maxId;
+    inst->tripleFilterValid_ = false;
+}
+
+/** save the bloom filter for load_triple_filter(), if it was built */
+static void save_triple_filter(librdf_storage *storage)
+{
+    Instance *inst = get_instance(storage);
+    if (!inst->tripleFilterValid_) {
+        return;
+    }
+
+    const cache::BlockedBloomFilter &filter = inst->tripleFilter_;
+    const uint64_t identity[2] = {inst->schemaFlags_,
+                                  inst->databaseId_.size()};
+    const uint64_t header[3] = {filter.capacity(), filter.items(),
+                                filter.words().size()};
+    // write to a temporary file so that a crash doesn't leave a torn snapshot
+    const string tmp = inst->tripleFilterFile_ + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    bool ok = f &&
+            fwrite(TRIPLE_FILTER_MAGIC, sizeof(TRIPLE_FILTER_MAGIC), 1, f) == 1 &&
+            fwrite(identity, sizeof(identity), 1, f) == 1 &&
+            fwrite(inst->databaseId_.data(), 1, inst->databaseId_.size(), f) ==
+                inst->databaseId_.size() &&
+            fwrite(&inst->filterMaxId_, sizeof(int64_t), 1, f) == 1 &&
+            fwrite(header, sizeof(header), 1, f) == 1 &&
+            fwrite(filter.words().data(), sizeof(uint64_t),
+                   filter.words().size(), f) == filter.words().size();
+    if (f) {
+        ok = (fclose(f) == 0) && ok;
+    }
+    if (!ok || rename(tmp.c_str(), inst->tripleFilterFile_.c_str()) != 0) {
+        remove(tmp.c_str());
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Failed to save the bloom filter snapshot %s",
+                   inst->tripleFilterFile_.c_str());
+    }
+}
+
+static int64_t get_triple_count(librdf_storage *storage)
+{
+    Instance *ctx = get_instance(storage);
+    DbStatement *st = ctx->getPrepStatement(ctx->tripleCount() ?
+                                            GET_TRIPLE_COUNT_MAINTAINED :
+                                            GET_TRIPLE_COUNT);
+    metrics::ScopedTimer timer = ctx->timeStatement();
+    return st->uniqueResult().getInt64(0);
+}
+
+static int64_t get_context_triple_count(librdf_storage *storage,
+                                        librdf_node *context_node)
+{
+    const int64_t cId = get_context_node_id(storage, context_node, false);
+    if (cId == 0) {
+        return 0;
+    }
+
+    Instance *ctx = get_instance(storage);
+    DbStatement *st = ctx->getPrepStatement(ctx->tripleCount() ?
+                                            GET_CONTEXT_TRIPLE_COUNT_MAINTAINED :
+                                            GET_CONTEXT_TRIPLE_COUNT);
+    metrics::ScopedTimer timer = ctx->timeStatement();
+    st->setInt(1, cId);
     return st->uniqueResult().getInt64(0);
 }
 
+/**
+ * After a commit, refresh the statistics of the indexes of the tables of
+ * at least STATS_MIN_ROWS rows in which more than statsFraction_ of the
+ * rows changed. The refresh runs on its own connection in a background
+ * thread, at most one at a time.
+ */
+static void refresh_index_statistics_if_needed(librdf_storage *storage)
+{
+    // don't bother with small tables
+    static const uint64_t STATS_MIN_ROWS = 1000;
+    static const char * const tables[CHANGED_TABLE_COUNT][2] = {
+        { "RESOURCE", "SEQ_RESOURCE" },
+        { "BNODE", "SEQ_BNODE" },
+        { "LITERAL", "SEQ_LITERAL" },
+        { "CONTEXT", "SEQ_CONTEXT" },
+        { "TRIPLE", "SEQ_TRIPLE" }
+    };
+
+    Instance *inst = get_instance(storage);
+    if (inst->statsFraction_ <= 0 || inst->statsRunning_) {
+        return;
+    }
+
+    if (inst->statsThread_.joinable()) {
+        inst->statsThread_.join();
+        if (!inst->statsError_.empty()) {
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN,
+                       LIBRDF_FROM_STORAGE, NULL,
+                       "Failed to update index statistics: %s",
+                       inst->statsError_.c_str());
+            inst->statsError_.clear();
+        }
+    }
+
+    std::vector<string> refresh;
+    try {
+        for (unsigned int i = 0; i != CHANGED_TABLE_COUNT; ++i) {
+            const uint64_t changed = inst->changedRows_[i];
+            if (changed == 0 ||
+                changed <= inst->statsFraction_ * STATS_MIN_ROWS) {
+                // too few changes for any table big enough, see below
+                continue;
+            }
+
+            // the sequence value is an upper bound of the table size that
+            // doesn't need a scan
+            string q = "SELECT GEN_ID(";
+            q += (inst->unifiedNodes() && i != CHANGED_CONTEXT &&
+                  i != CHANGED_TRIPLE) ? "SEQ_NODE" : tables[i][1];
+            q += ", 0) FROM RDB$DATABASE";
+            DbStatement st = inst->db_.createStatement(q.c_str(), &inst->tr_);
+            const int64_t rows = st.uniqueResult().getInt64(0);
+            if (rows < (int64_t) STATS_MIN_ROWS) {
+                continue;
+            }
+            if (changed > inst->statsFraction_ * rows) {
+                refresh.emplace_back(tables[i][0]);
+                inst->changedRows_[i] = 0;
+            }
+        }
+    } catch (std::exception &e) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Failed to check table sizes: %s", e.what());
+        return;
+    }
+
+    if (refresh.empty()) {
+        return;
+    }
+
+    inst->statsRunning_ = true;
+    inst->statsThread_ = std::thread([inst, refresh]() {
+        try {
+            update_index_statistics(inst->dbName_.c_str(),
+                    inst->server_.empty() ? nullptr : inst->server_.c_str(),
+                    inst->userName_.empty() ? nullptr : inst->userName_.c_str(),
+                    inst->userPassword_.empty() ? nullptr :
+                                                  inst->userPassword_.c_str(),
+                    refresh);
+        } catch (std::exception &e) {
+            inst->statsError_ = e.what();
+        }
+        inst->statsRunning_ = false;
+    });
+}
+
 } // namespace impl
 
 /*
@@ -626,6 +1701,8 @@ static int64_t find_statement(librdf_storage *storage,
 
 using namespace impl;
 
+static void prepare_statements(librdf_storage *storage, const char *shapes);
+
 /**
  * Create a new storage.
  *
@@ -649,6 +1726,103 @@ static int pub_init(librdf_storage *storage, const char *name,
         update_index_stats = true;
     }
 
+    unsigned int schema_flags = SCHEMA_DEFAULT;
+    if(librdf_hash_get_as_boolean(options, "composite_indexes") == 1) {
+        schema_flags |= SCHEMA_COMPOSITE_INDEXES;
+    }
+    if(librdf_hash_get_as_boolean(options, "unified_nodes") == 1) {
+        schema_flags |= SCHEMA_UNIFIED_NODES;
+    }
+    if(librdf_hash_get_as_boolean(options, "hash_lookup") == 1) {
+        schema_flags |= SCHEMA_HASH_LOOKUP;
+    }
+    if(librdf_hash_get_as_boolean(options, "triple_count") == 1) {
+        schema_flags |= SCHEMA_TRIPLE_COUNT;
+    }
+    if(librdf_hash_get_as_boolean(options, "triple_log") == 1) {
+        schema_flags |= SCHEMA_TRIPLE_LOG;
+    }
+    if(librdf_hash_get_as_boolean(options, "long_literals") == 1) {
+        // long literals are found through their hash
+        schema_flags |= SCHEMA_LONG_LITERALS | SCHEMA_HASH_LOOKUP;
+    }
+
+    double index_stats_fraction = 0;
+    char *fraction = librdf_hash_get(options, "index_stats_fraction");
+    if (fraction) {
+        index_stats_fraction = atof(fraction);
+        free(fraction);
+    }
+
+    unsigned int match_pool_size = MATCH_POOL_SIZE;
+    char *pool_size = librdf_hash_get(options, "match_pool_size");
+    if (pool_size) {
+        match_pool_size = (unsigned int) strtoul(pool_size, nullptr, 10);
+        free(pool_size);
+    }
+
+    unsigned int match_idle_seconds = MATCH_IDLE_SECONDS;
+    char *idle_seconds = librdf_hash_get(options, "match_idle_seconds");
+    if (idle_seconds) {
+        match_idle_seconds = (unsigned int) strtoul(idle_seconds, nullptr, 10);
+        free(idle_seconds);
+    }
+
+    unsigned int slow_query_ms = 0;
+    char *slow_ms = librdf_hash_get(options, "slow_query_ms");
+    if (slow_ms) {
+        slow_query_ms = (unsigned int) strtoul(slow_ms, nullptr, 10);
+        free(slow_ms);
+    }
+
+    unsigned int slow_query_sample = 1;
+    char *sample = librdf_hash_get(options, "slow_query_sample");
+    if (sample) {
+        slow_query_sample = (unsigned int) strtoul(sample, nullptr, 10);
+        free(sample);
+    }
+    std::unique_ptr<char, decltype(&free)> slow_query_file(
+                    librdf_hash_get(options, "slow_query_file"), &free);
+
+    bool explain_plans = false;
+    if(librdf_hash_get_as_boolean(options, "explain_plans") == 1) {
+        explain_plans = true;
+    }
+
+    bool remove_orphan_nodes = false;
+    if(librdf_hash_get_as_boolean(options, "remove_orphan_nodes") == 1) {
+        remove_orphan_nodes = true;
+    }
+
+    bool triple_filter = false;
+    if(librdf_hash_get_as_boolean(options, "bloom_filter") == 1) {
+        triple_filter = true;
+    }
+    std::unique_ptr<char, decltype(&free)> filter_file(
+                    librdf_hash_get(options, "bloom_filter_file"), &free);
+
+    bool prepare_all = false;
+    if(librdf_hash_get_as_boolean(options, "prepare_statements") == 1) {
+        prepare_all = true;
+    }
+    std::unique_ptr<char, decltype(&free)> match_shapes(
+                    librdf_hash_get(options, "prepare_match_shapes"), &free);
+
+    bool metrics_enabled = true;
+    if(librdf_hash_get_as_boolean(options, "metrics") == 0) {
+        metrics_enabled = false;
+    }
+
+    bool fast_load = false;
+    if(librdf_hash_get_as_boolean(options, "fastload") == 1) {
+        fast_load = true;
+    }
+
+    bool migrate_unified = false;
+    if(librdf_hash_get_as_boolean(options, "migrate_unified_nodes") == 1) {
+        migrate_unified = true;
+    }
+
     // "new='yes',host='localhost',database='red',user='foo','password='bar'"
     std::unique_ptr<char, decltype(&free)> server(librdf_hash_get(options, "host"), &free);
     std::unique_ptr<char, decltype(&free)> user(librdf_hash_get(options, "user"), &free);
@@ -658,7 +1832,13 @@ static int pub_init(librdf_storage *storage, const char *name,
     try {
 
         if (is_new) {
-            create_firebird_rdf_db(name, server.get(), user.get(), password.get());
+            create_firebird_rdf_db(name, server.get(), user.get(), password.get(),
+                                   schema_flags);
+        }
+
+        if (migrate_unified) {
+            migrate_to_unified_schema(name, server.get(), user.get(),
+                                      password.get());
         }
 
         if (update_index_stats) {
@@ -667,9 +1847,68 @@ static int pub_init(librdf_storage *storage, const char *name,
         }
 
         Instance *inst = new Instance(name, server.get(), user.get(), password.get());
+        inst->removeOrphanNodes_ = remove_orphan_nodes;
+        inst->statsFraction_ = index_stats_fraction;
+        inst->fastLoad_ = fast_load;
+        inst->metricsEnabled_ = metrics_enabled;
+        inst->matchPoolSize_ = match_pool_size;
+        inst->matchIdleSeconds_ = match_idle_seconds;
+        inst->useTripleFilter_ = triple_filter || filter_file;
+        inst->slowQueryMs_ = slow_query_ms;
+        inst->slowQuerySample_ = slow_query_sample ? slow_query_sample : 1;
+        inst->explainPlans_ = explain_plans;
 
         librdf_storage_set_instance(storage, inst);
 
+        try {
+            // databases created before garbage collection was added
+            create_missing_table(inst->db_, "NODE_GC_STATE");
+        } catch (std::exception &e) {
+            // e.g. a user who may not create tables, only the garbage
+            // collection needs it
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN,
+                       LIBRDF_FROM_STORAGE, NULL,
+                       "Cannot create NODE_GC_STATE: %s", e.what());
+        }
+
+        if (fast_load) {
+            // marked before the indexes are deactivated so that an
+            // interrupted load is recognized, pub_terminate rebuilds them
+            inst->fastLoadAttachment_ = register_fast_load(inst->db_,
+                                                           inst->tr_);
+            inst->tr_.commitRetain();
+            deactivate_triple_indexes(name, server.get(), user.get(),
+                                      password.get());
+        } else if (fast_load_interrupted(inst->db_, inst->tr_) &&
+                   end_fast_load(name, server.get(), user.get(),
+                                 password.get(), 0) != 0) {
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN,
+                       LIBRDF_FROM_STORAGE, NULL,
+                       "Reactivated the TRIPLE indexes of an interrupted "
+                       "fast load");
+        }
+
+        if (slow_query_ms && slow_query_file) {
+            inst->slowQueryLog_ = fopen(slow_query_file.get(), "a");
+            if (!inst->slowQueryLog_) {
+                librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN,
+                           LIBRDF_FROM_STORAGE, NULL,
+                           "Cannot open the slow query log %s, using "
+                           "librdf_log instead", slow_query_file.get());
+            }
+        }
+
+        if (filter_file) {
+            inst->tripleFilterFile_ = filter_file.get();
+            inst->databaseId_ = inst->getPrepStatement(GET_DATABASE_ID)
+                                            ->uniqueResult().getText(0);
+            load_triple_filter(storage);
+        }
+
+        if (prepare_all || match_shapes) {
+            prepare_statements(storage, match_shapes.get());
+        }
+
     } catch (std::exception &e) {
         librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE,
                    NULL, "Database initialization error: %s", e.what());
@@ -684,7 +1923,35 @@ static int pub_init(librdf_storage *storage, const char *name,
 static void pub_terminate(librdf_storage *storage)
 {
     Instance *inst = get_instance(storage);
+    if (inst && !inst->tripleFilterFile_.empty()) {
+        save_triple_filter(storage);
+    }
+
+    if (!inst || !inst->fastLoad_) {
+        delete inst;
+        return;
+    }
+
+    // rebuild the TRIPLE indexes once the loading connection is closed,
+    // unless other connections are still loading
+    const string name = inst->dbName_;
+    const string server = inst->server_;
+    const string user = inst->userName_;
+    const string password = inst->userPassword_;
+    const int64_t attachment = inst->fastLoadAttachment_;
     delete inst;
+
+    try {
+        end_fast_load(name.c_str(),
+                      server.empty() ? nullptr : server.c_str(),
+                      user.empty() ? nullptr : user.c_str(),
+                      password.empty() ? nullptr : password.c_str(),
+                      attachment);
+    } catch (std::exception &e) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE,
+                   NULL, "Failed to reactivate the TRIPLE indexes: %s",
+                   e.what());
+    }
 }
 
 
@@ -693,13 +1960,16 @@ static int pub_close(librdf_storage *storage)
     int rc = RET_OK;
     Instance *inst = get_instance(storage);
 
+    compact_triple_count_if_needed(storage);
     try {
+        metrics::ScopedTimer timer = inst->time(inst->commitStats_);
         inst->tr_.commitRetain();
     } catch (std::exception &e) {
         rc = RET_ERROR;
         librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE,
                    NULL, "Failed to commit transaction: %s", e.what());
     }
+    inst->evictIdleMatchStatements();
     return rc;
 }
 
@@ -711,6 +1981,101 @@ static int pub_open(librdf_storage * /* storage */, librdf_model */* model */)
 }
 
 
+/** append " name=value" to a statistics line */
+static void append_stat(string &out, const char *name, uint64_t value)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), " %s=%llu", name, (unsigned long long) value);
+    out += buf;
+}
+
+/** append the count and latency percentiles (in microseconds) of a histogram */
+static void append_latency(string &out, const metrics::OperationStats &stats)
+{
+    const metrics::LatencyHistogram *h = stats.recorded();
+    if (!h) {
+        return;
+    }
+
+    char buf[160];
+    snprintf(buf, sizeof(buf),
+             " timed=%llu mean_us=%.1f p50_us=%.1f p90_us=%.1f p99_us=%.1f"
+             " max_us=%.1f",
+             (unsigned long long) h->count(),
+             h->count() ? h->total() / 1000.0 / (double) h->count() : 0.0,
+             h->percentile(0.5) / 1000.0, h->percentile(0.9) / 1000.0,
+             h->percentile(0.99) / 1000.0, h->max() / 1000.0);
+    out += buf;
+}
+
+/**
+ * Format the instance statistics, one line per item: the kind of item, its
+ * name and space separated name=value pairs. Unused items are left out.
+ */
+static string format_stats(librdf_storage *storage)
+{
+    Instance *inst = get_instance(storage);
+    string out;
+
+    for (unsigned int i = 0; i != LAST_PREP_STATEMENT_IDX; ++i) {
+        if (inst->statementCalls_[i] == 0) {
+            continue;
+        }
+        out += "statement ";
+        out += PREP_STATEMENT_NAMES[i];
+        append_stat(out, "calls", inst->statementCalls_[i]);
+        append_latency(out, inst->statementStats_[i]);
+        out += "\n";
+    }
+
+    for (unsigned int i = 0;
+            i != MatchPreparedStatements::MATCH_STATEMENTS_COUNT; ++i) {
+        const MatchPreparedStatement &mps = inst->matchStatements_.get(i);
+        if (mps.prepares == 0) {
+            continue;
+        }
+        out += "match " + std::to_string(i);
+        append_stat(out, "queries", mps.prepares + mps.reuses);
+        append_stat(out, "prepares", mps.prepares);
+        append_stat(out, "rows", inst->matchRows_[i]);
+        // the latency is the time to the first row
+        append_latency(out, inst->matchStats_[i]);
+        out += "\n";
+    }
+
+    out += "cache resources";
+    append_stat(out, "hits", inst->resCache.hits());
+    append_stat(out, "misses", inst->resCache.misses());
+    append_stat(out, "evictions", inst->resCache.evictions());
+    append_stat(out, "size", inst->resCache.size());
+    out += "\n";
+
+    if (inst->useTripleFilter_) {
+        out += "cache bloom_filter";
+        append_stat(out, "checks", inst->filterChecks_);
+        append_stat(out, "negatives", inst->filterNegatives_);
+        append_stat(out, "items", inst->tripleFilter_.items());
+        out += "\n";
+    }
+
+    const std::pair<const char*, const metrics::OperationStats*> ops[] = {
+        { "decode_row", &inst->decodeStats_ },
+        { "commit", &inst->commitStats_ },
+        { "rollback", &inst->rollbackStats_ }
+    };
+    for (const auto &op : ops) {
+        const metrics::LatencyHistogram *h = op.second->recorded();
+        if (h) {
+            out += "operation ";
+            out += op.first;
+            append_latency(out, *op.second);
+            out += "\n";
+        }
+    }
+
+    return out;
+}
+
 /**
  * librdf_storage_firebird_get_feature:
  * @storage: #librdf_storage object
@@ -736,12 +2101,20 @@ static librdf_node *pub_get_feature(librdf_storage *storage, librdf_uri *feature
                                                   (const unsigned char*) "1",
                                                   NULL, NULL);
     }
+    if(!strcmp((const char*) uri_string, LIBRDF_STORAGE_FIREBIRD_FEATURE_STATS)) {
+        const string stats = format_stats(storage);
+        return librdf_new_node_from_typed_literal(get_world(storage),
+                                    (const unsigned char*) stats.c_str(),
+                                    NULL, NULL);
+    }
     return NULL;
 }
 
-static int pub_transaction_start(librdf_storage * /* storage */)
+static int pub_transaction_start(librdf_storage *storage)
 {
-    // We already are using a transaction.
+    // We already are using a transaction, only remember that the changes up
+    // to the next commit or rollback belong together.
+    get_instance(storage)->userTransaction_ = true;
     return 0;
 }
 
@@ -750,13 +2123,21 @@ static int pub_transaction_commit(librdf_storage *storage)
 {
     int rc = RET_OK;
     Instance *inst = get_instance(storage);
+    inst->userTransaction_ = false;
+    compact_triple_count_if_needed(storage);
     try {
+        metrics::ScopedTimer timer = inst->time(inst->commitStats_);
         inst->tr_.commitRetain();
     } catch (std::exception &e) {
         rc = RET_ERROR;
         librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE,
                    NULL, "Failed to commit transaction: %s", e.what());
     }
+
+    if (rc == RET_OK) {
+        refresh_index_statistics_if_needed(storage);
+    }
+    inst->evictIdleMatchStatements();
     return rc;
 }
 
@@ -764,13 +2145,18 @@ static int pub_transaction_rollback(librdf_storage *storage)
 {
     int rc = RET_OK;
     Instance *inst = get_instance(storage);
+    inst->userTransaction_ = false;
     try {
+        metrics::ScopedTimer timer = inst->time(inst->rollbackStats_);
         inst->tr_.rollbackRetain();
+        // statements added since the last commit are gone
+        inst->invalidateLoadedTriples();
     } catch (std::exception &e) {
         rc = RET_ERROR;
         librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE,
                    NULL, "Failed to rollback transaction: %s", e.what());
     }
+    inst->evictIdleMatchStatements();
     return rc;
 }
 
@@ -813,6 +2199,16 @@ librdf_stream *make_empty_stream(librdf_world *w)
 
 namespace statement_stream {
 
+/** what the slow query log records of a match query */
+struct QueryTrace
+{
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration firstRow;
+    uint64_t rows;
+    // the bound parameters, e.g. "1=42 2='http://example.org/'"
+    string parameters;
+};
+
 struct StatementIterator
 {
     librdf_storage *storage;
@@ -823,25 +2219,134 @@ struct StatementIterator
     DbStatement *stmt;
     DbStatement::Iterator *it;
     unsigned int prepStatementIndex;
+    Instance::PooledStatement *pooled;
+    // null unless the query is traced for the slow query log
+    QueryTrace *trace;
     bool dirty;
 };
 
-static int statement_iter_end_of_stream(void *ctx)
+/** start tracing a match query if it is sampled for the slow query log */
+static QueryTrace *start_query_trace(Instance *inst)
 {
-    assert(ctx && "context mustn't be NULL");
-    StatementIterator *iter = (StatementIterator*) ctx;
-    return !iter->it || !(*iter->it != iter->stmt->end());
+    if (!inst->traceMatchQuery()) {
+        return nullptr;
+    }
+    QueryTrace *trace = new QueryTrace();
+    trace->start = std::chrono::steady_clock::now();
+    trace->rows = 0;
+    return trace;
 }
 
-static int statement_iter_next_statement(void *ctx)
+/** record a bound parameter of a traced query, long texts are shortened */
+static void trace_parameter(QueryTrace *trace, unsigned int n,
+                            const char *text, int64_t id)
 {
-    assert(ctx && "context mustn't be NULL");
-    StatementIterator *iter = (StatementIterator*) ctx;
-    if (statement_iter_end_of_stream(iter)) {
-        return RET_ERROR;
+    static const size_t MAX_TEXT = 100;
+    if (!trace->parameters.empty()) {
+        trace->parameters += ' ';
+    }
+    trace->parameters += std::to_string(n);
+    trace->parameters += '=';
+    if (!text) {
+        trace->parameters += std::to_string(id);
+        return;
     }
+    const size_t len = strlen(text);
+    trace->parameters += '\'';
+    trace->parameters.append(text, std::min(len, MAX_TEXT));
+    trace->parameters += len > MAX_TEXT ? "...'" : "'";
+}
 
-    iter->dirty = true;
+/** note the first row of a traced query once it was executed */
+static void trace_executed(StatementIterator *iter)
+{
+    QueryTrace *trace = iter->trace;
+    if (trace) {
+        trace->firstRow = std::chrono::steady_clock::now() - trace->start;
+        trace->rows = *iter->it != iter->stmt->end() ? 1 : 0;
+    }
+}
+
+/** log a traced query which took longer than the slow query threshold */
+static void finish_query_trace(StatementIterator *iter)
+{
+    using std::chrono::microseconds;
+    using std::chrono::duration_cast;
+
+    QueryTrace *trace = iter->trace;
+    Instance *inst = get_instance(iter->storage);
+    const std::chrono::steady_clock::duration total =
+                std::chrono::steady_clock::now() - trace->start;
+    if (total < std::chrono::milliseconds(inst->slowQueryMs_)) {
+        delete trace;
+        return;
+    }
+
+    const double totalMs = duration_cast<microseconds>(total).count() / 1000.0;
+    const double firstRowMs =
+            duration_cast<microseconds>(trace->firstRow).count() / 1000.0;
+    const string &sql = inst->matchStatements_.get(iter->prepStatementIndex).sql;
+
+    if (inst->slowQueryLog_) {
+        char when[32];
+        const time_t now = ::time(nullptr);
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        fprintf(inst->slowQueryLog_,
+                "# %s match query %u: %.3f ms, first row after %.3f ms, "
+                "%llu rows, parameters: %s\n%s\n\n",
+                when, iter->prepStatementIndex, totalMs, firstRowMs,
+                (unsigned long long) trace->rows, trace->parameters.c_str(),
+                sql.c_str());
+        fflush(inst->slowQueryLog_);
+    } else {
+        librdf_log(get_world(iter->storage), 0, LIBRDF_LOG_WARN,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Slow match query %u: %.3f ms, first row after %.3f ms, "
+                   "%llu rows, parameters: %s\n%s",
+                   iter->prepStatementIndex, totalMs, firstRowMs,
+                   (unsigned long long) trace->rows,
+                   trace->parameters.c_str(), sql.c_str());
+    }
+    delete trace;
+}
+
+/**
+ * Queries don't always select the nodes bound in the search pattern, these
+ * are taken from the pattern instead.
+ */
+static inline librdf_node *copy_pattern_node(
+                                librdf_statement *pattern,
+                                librdf_node *(*getNode)(librdf_statement*))
+{
+    librdf_node *node = pattern ? getNode(pattern) : nullptr;
+    return node ? librdf_new_node_from_node(node) : nullptr;
+}
+
+static string get_long_literal_value(librdf_storage *storage, int64_t id)
+{
+    Instance *ctx = get_instance(storage);
+    DbStatement *st = ctx->getPrepStatement(GET_LONG_LITERAL_VAL);
+    metrics::ScopedTimer timer = ctx->timeStatement();
+    st->setInt(1, id);
+    return st->uniqueResult().getText(0);
+}
+
+static int statement_iter_end_of_stream(void *ctx)
+{
+    assert(ctx && "context mustn't be NULL");
+    StatementIterator *iter = (StatementIterator*) ctx;
+    return !iter->it || !(*iter->it != iter->stmt->end());
+}
+
+static int statement_iter_next_statement(void *ctx)
+{
+    assert(ctx && "context mustn't be NULL");
+    StatementIterator *iter = (StatementIterator*) ctx;
+    if (statement_iter_end_of_stream(iter)) {
+        return RET_ERROR;
+    }
+
+    iter->dirty = true;
 
     // move to the next item
     ++(*iter->it);
@@ -850,6 +2355,9 @@ static int statement_iter_next_statement(void *ctx)
         return RET_ERROR;
     }
 
+    if (iter->trace) {
+        iter->trace->rows++;
+    }
     return RET_OK;
 }
 
@@ -880,6 +2388,9 @@ static void *statement_iter_get_statement(void *ctx, const int getMethod)
     assert(iter->statement && "statement mustn't be NULL");
     librdf_world *w = get_world(iter->storage);
     librdf_statement *st = iter->statement;
+    Instance *inst = get_instance(iter->storage);
+    inst->matchRows_[iter->prepStatementIndex]++;
+    metrics::ScopedTimer timer = inst->time(inst->decodeStats_);
 
     // row columns refer to find_triples_sql
     fb::DbRowProxy row = *(*iter->it);
@@ -901,6 +2412,11 @@ static void *statement_iter_get_statement(void *ctx, const int getMethod)
                 (const unsigned char*) row.getText(IDX_S_BLANK).c_str());
     }
 
+    if(!node) {
+        node = copy_pattern_node(iter->pattern,
+                                 &librdf_statement_get_subject);
+    }
+
     if(!node) {
         return NULL;
     }
@@ -915,6 +2431,11 @@ static void *statement_iter_get_statement(void *ctx, const int getMethod)
                 (const unsigned char*) row.getText(IDX_P_URI).c_str());
     }
 
+    if(!node) {
+        node = copy_pattern_node(iter->pattern,
+                                 &librdf_statement_get_predicate);
+    }
+
     if(!node) {
         return NULL;
     }
@@ -939,6 +2460,11 @@ static void *statement_iter_get_statement(void *ctx, const int getMethod)
 
     if (!node) {
         field = row.getText(IDX_O_TEXT);
+        if (field.empty() && !row.fieldIsNull(IDX_O_LONG_LITERAL)) {
+            // only rows holding a long literal read its BLOB
+            field = get_long_literal_value(iter->storage,
+                                           row.getInt64(IDX_O_LONG_LITERAL));
+        }
         if (!field.empty()) { // TODO: should we better check for null?
             string lang = row.getText(IDX_O_LANGUAGE);
             string dataType = row.getText(IDX_O_DATATYPE);
@@ -955,6 +2481,11 @@ static void *statement_iter_get_statement(void *ctx, const int getMethod)
         }
     }
 
+    if (!node) {
+        node = copy_pattern_node(iter->pattern,
+                                 &librdf_statement_get_object);
+    }
+
     if (!node) {
         return NULL;
     }
@@ -984,9 +2515,13 @@ static void statement_iter_finished(void *ctx)
 
     librdf_storage_remove_reference(iter->storage);
 
+    if (iter->trace) {
+        finish_query_trace(iter);
+    }
+
     delete iter->it;
     Instance *inst = get_instance(iter->storage);
-    inst->releaseMatchStatement(iter->prepStatementIndex, (void*) iter);
+    inst->releaseMatchStatement(iter->prepStatementIndex, iter->pooled);
     LIBRDF_FREE(Iterator*, iter);
 }
 
@@ -1101,23 +2636,21 @@ static void context_iter_finished(void *ctx)
 
 static int pub_size(librdf_storage *storage)
 {
-    Instance *ctx = get_instance(storage);
-    DbStatement *st = ctx->getPrepStatement(GET_TRIPLE_COUNT);
-    return (int) st->uniqueResult().getInt64(0);
+    const int64_t n = get_triple_count(storage);
+    return n > INT_MAX ? INT_MAX : (int) n;
 }
 
 static librdf_iterator *pub_get_contexts(librdf_storage *storage)
 {
-#if 0
-    (void) storage;
-    return NULL;
-#else
-    // TODO: this is very inefficient, the database schema needs to change to
-    // implement this properly!
+    // only list contexts which have statements, with a maintained triple
+    // count the TRIPLE table isn't searched at all
     using namespace context_stream;
+    Instance *inst = get_instance(storage);
     ContextIterator *iter = LIBRDF_CALLOC(ContextIterator*, sizeof(ContextIterator), 1);
     iter->storage = storage;
-    iter->stmt = get_instance(storage)->getPrepStatement(GET_CONTEXTS);
+    iter->stmt = inst->getPrepStatement(inst->tripleCount() ?
+                                        GET_CONTEXTS_MAINTAINED :
+                                        GET_CONTEXTS);
     iter->it = new DbStatement::Iterator(std::move(iter->stmt->iterate()));
     iter->dirty = true;
     librdf_storage_add_reference(iter->storage);
@@ -1130,7 +2663,6 @@ static librdf_iterator *pub_get_contexts(librdf_storage *storage)
         context_iter_finished(iter);
     }
     return iterator;
-#endif
 }
 
 static int pub_contains_statement(librdf_storage *storage,
@@ -1139,13 +2671,330 @@ static int pub_contains_statement(librdf_storage *storage,
     return (find_statement(storage, 0, statement, false) != 0);
 }
 
-static librdf_stream *pub_context_find_statements(librdf_storage *storage,
-                                                  librdf_statement *statement,
-                                                  librdf_node *context_node)
+/**
+ * Return the ID of a node bound in a search pattern, 0 if no such node exists
+ * or -1 if the node is not bound.
+ */
+static int64_t get_pattern_node_id(librdf_storage *storage, librdf_node *node)
+{
+    size_t len = 0;
+    switch (node_type(node)) {
+    case LIBRDF_NODE_TYPE_RESOURCE:
+        return get_resource_id(storage, (const char*)
+                    librdf_uri_as_counted_string(librdf_node_get_uri(node),
+                                                 &len));
+    case LIBRDF_NODE_TYPE_BLANK:
+        return get_blank_id(storage, (const char*)
+                    librdf_node_get_counted_blank_identifier(node, &len));
+    case LIBRDF_NODE_TYPE_LITERAL:
+    {
+        librdf_uri *uri = librdf_node_get_literal_value_datatype_uri(node);
+        return get_literal_id(storage, (const char*)
+                    librdf_node_get_literal_value_as_counted_string(node, &len),
+                    librdf_node_get_literal_value_language(node),
+                    uri ? (const char*) librdf_uri_as_string(uri) : nullptr);
+    }
+    default:
+        return -1;
+    }
+}
+
+/** IDs of the nodes bound in a search pattern, see get_pattern_node_id */
+struct PatternIds
+{
+    int64_t s;
+    int64_t p;
+    int64_t o;
+    int64_t c;
+    // conditions on TRIPLE r matching the bound IDs, each starts with " AND "
+    string where;
+    int64_t parameters[4];
+    unsigned int count;
+    // bit mask of the bound positions: s=0x8, p=0x4, o=0x2, c=0x1
+    unsigned int qindex;
+};
+
+/**
+ * Resolve the nodes bound in a search pattern to IDs and build the
+ * conditions matching them. Return false if a bound node doesn't exist and
+ * nothing can match. With prepareOnly the bound nodes aren't looked up, only
+ * the conditions are built.
+ */
+static bool get_pattern_ids(librdf_storage *storage,
+                            librdf_statement *statement,
+                            librdf_node *context_node,
+                            PatternIds &ids,
+                            bool prepareOnly = false)
+{
+    Instance *ctx = get_instance(storage);
+
+    librdf_node *s = librdf_statement_get_subject(statement);
+    librdf_node *p = librdf_statement_get_predicate(statement);
+    librdf_node *o = librdf_statement_get_object(statement);
+
+    if (node_type(s) == LIBRDF_NODE_TYPE_LITERAL ||
+        (p && node_type(p) != LIBRDF_NODE_TYPE_RESOURCE)) {
+        // ain't no literal a subject, no predicate anything but a resource
+        return false;
+    }
+
+    if (prepareOnly) {
+        // any existing ID will do
+        ids.s = s ? 1 : -1;
+        ids.p = p ? 1 : -1;
+        ids.o = o ? 1 : -1;
+        ids.c = context_node ? 1 : -1;
+    } else {
+        ids.s = get_pattern_node_id(storage, s);
+        ids.p = get_pattern_node_id(storage, p);
+        ids.o = get_pattern_node_id(storage, o);
+        ids.c = context_node ?
+                get_context_node_id(storage, context_node, false) : -1;
+    }
+
+    if (ids.s == 0 || ids.p == 0 || ids.o == 0 || ids.c == 0) {
+        // a bound node doesn't exist, nothing can match
+        return false;
+    }
+
+    ids.where.clear();
+    ids.count = 0;
+    ids.qindex = 0;
+
+    // the unified layout has one column per position, the original one
+    // a column per node table
+    const bool unified = ctx->unifiedNodes();
+    if (ids.s > 0) {
+        ids.where += unified ? " AND r.S_ID=?" :
+                     node_type(s) == LIBRDF_NODE_TYPE_RESOURCE ?
+                                    " AND r.S_URI=?" : " AND r.S_BLANK=?";
+        ids.parameters[ids.count++] = ids.s;
+        ids.qindex |= 0x8;
+    }
+
+    if (ids.p > 0) {
+        ids.where += " AND r.P_URI=?";
+        ids.parameters[ids.count++] = ids.p;
+        ids.qindex |= 0x4;
+    }
+
+    if (ids.o > 0) {
+        ids.where += unified ? " AND r.O_ID=?" :
+                     node_type(o) == LIBRDF_NODE_TYPE_RESOURCE ?
+                                    " AND r.O_URI=?" :
+                     node_type(o) == LIBRDF_NODE_TYPE_BLANK ?
+                                    " AND r.O_BLANK=?" : " AND r.O_LITERAL=?";
+        ids.parameters[ids.count++] = ids.o;
+        ids.qindex |= 0x2;
+    }
+
+    if (ids.c > 0) {
+        ids.where += " AND r.C_URI=?";
+        ids.parameters[ids.count++] = ids.c;
+        ids.qindex |= 0x1;
+    }
+
+    return true;
+}
+
+/** whether an explained plan reads the whole TRIPLE table */
+static bool plan_scans_triple(const string &plan)
+{
+    // e.g. '-> Table "TRIPLE" as "R" Full Scan'
+    size_t pos = 0;
+    while ((pos = plan.find("Table \"TRIPLE\"", pos)) != string::npos) {
+        const size_t eol = plan.find('\n', pos);
+        if (plan.substr(pos, eol - pos).find("Full Scan") != string::npos) {
+            return true;
+        }
+        pos = eol;
+    }
+    return false;
+}
+
+/**
+ * Log the plan Firebird chose for a match query shape the first time its
+ * statement is prepared, with a warning if it scans the whole TRIPLE table.
+ * The plan is read from the monitoring tables, which hold the explained plan
+ * of every statement prepared by the attachment (Firebird 3 and later).
+ */
+static void explain_match_statement(librdf_storage *storage,
+                                    unsigned int qindex)
+{
+    Instance *inst = get_instance(storage);
+    if (!inst->explainPlans_ || inst->explained_[qindex]) {
+        return;
+    }
+    inst->explained_[qindex] = true;
+
+    const string &sql = inst->matchStatements_.get(qindex).sql;
+    string plan;
+    try {
+        // a new transaction sees a new monitoring snapshot
+        DbTransaction tr{inst->db_.nativeHandle(), 1};
+        DbStatement st = inst->db_.createStatement(
+                "SELECT FIRST 8 MON$SQL_TEXT, MON$EXPLAINED_PLAN "
+                "FROM MON$STATEMENTS "
+                "WHERE MON$ATTACHMENT_ID = CURRENT_CONNECTION "
+                "ORDER BY MON$STATEMENT_ID DESC", &tr);
+        for (DbStatement::Iterator i = st.iterate(); i != st.end(); ++i) {
+            fb::DbRowProxy row = *i;
+            if (!row.fieldIsNull(1) && row.getText(0) == sql) {
+                plan = row.getText(1);
+                break;
+            }
+        }
+    } catch (std::exception &e) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Cannot read the plan of match query %u: %s",
+                   qindex, e.what());
+        return;
+    }
+
+    if (plan.empty()) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "No plan found for match query %u", qindex);
+    } else if (plan_scans_triple(plan)) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE,
+                   NULL, "Match query %u reads all of TRIPLE:\n%s\n%s",
+                   qindex, plan.c_str(), sql.c_str());
+    } else {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_INFO, LIBRDF_FROM_STORAGE,
+                   NULL, "Plan of match query %u:\n%s", qindex, plan.c_str());
+    }
+}
+
+/**
+ * Find statements in a SCHEMA_UNIFIED_NODES database. The bound nodes are
+ * resolved to IDs first, so the query only depends on which of the four
+ * positions are bound. With prepareOnly the query is only prepared for
+ * later use and NULL is returned.
+ */
+static librdf_stream *find_unified_statements(librdf_storage *storage,
+                                              librdf_statement *statement,
+                                              librdf_node *context_node,
+                                              bool prepareOnly)
+{
+    Instance *db_ctx = get_instance(storage);
+    librdf_world *w = get_world(storage);
+
+    PatternIds ids;
+    if (!get_pattern_ids(storage, statement, context_node, ids, prepareOnly)) {
+        return prepareOnly ? nullptr : impl::empty_stream::make_empty_stream(w);
+    }
+
+    // the nodes bound in the pattern are not selected, the stream iterator
+    // takes them from the pattern
+    string query = "SELECT r.ID as statement_id,\n";
+    string joins;
+
+    if (ids.s > 0) {
+        query += "null as s_uri,\nnull as s_blank,\n";
+    } else {
+        query += "rs.URI as s_uri,\nbs.NAME as s_blank,\n";
+        joins += "LEFT JOIN RESOURCE rs ON r.S_KIND = 1 AND r.S_ID = rs.ID\n"
+                 "LEFT JOIN BNODE bs ON r.S_KIND = 2 AND r.S_ID = bs.ID\n";
+    }
+
+    if (ids.p > 0) {
+        query += "null as predicate,\n";
+    } else {
+        query += "rp.URI as predicate,\n";
+        joins.insert(0, "JOIN RESOURCE rp ON r.P_URI = rp.ID\n");
+    }
+
+    if (ids.o > 0) {
+        query += "null as o_uri,\nnull as o_blank,\nnull as o_literal,\n"
+                 "null as o_lit_lang,\nnull as o_lit_dt,\n";
+    } else {
+        query += "ro.URI as o_uri,\nbo.NAME as o_blank,\nlo.VAL as o_literal,\n"
+                 "lo.LANGUAGE as o_lit_lang,\nldt.URI as o_lit_dt,\n";
+        joins += "LEFT JOIN RESOURCE ro ON r.O_KIND = 1 AND r.O_ID = ro.ID\n"
+                 "LEFT JOIN BNODE bo ON r.O_KIND = 2 AND r.O_ID = bo.ID\n"
+                 "LEFT JOIN LITERAL lo ON r.O_KIND = 3 AND r.O_ID = lo.ID\n"
+                 "LEFT JOIN RESOURCE ldt ON lo.DATATYPE = ldt.ID\n";
+    }
+
+    if (ids.c > 0) {
+        query += "null as context,\n";
+    } else {
+        query += "c.URI as context,\n";
+        joins += "LEFT JOIN CONTEXT c ON r.C_URI = c.ID\n";
+    }
+
+    query += (ids.o < 0 && db_ctx->longLiterals()) ?
+                "IIF(lo.VAL IS NULL, lo.ID, NULL) as o_long_literal" :
+                "null as o_long_literal";
+
+    query += "\nFROM TRIPLE r\n";
+    query += joins;
+    if (!ids.where.empty()) {
+        // replace the leading " AND "
+        query += "WHERE";
+        query.append(ids.where, 4, string::npos);
+    }
+
+    if (prepareOnly) {
+        Instance::PooledStatement *p = db_ctx->acquireMatchStatement(ids.qindex,
+                                                                     &query);
+        explain_match_statement(storage, ids.qindex);
+        db_ctx->releaseMatchStatement(ids.qindex, p);
+        return nullptr;
+    }
+
+    // create iterator
+    using namespace statement_stream;
+    StatementIterator *iter = LIBRDF_CALLOC(
+            StatementIterator *, sizeof(StatementIterator), 1);
+    iter->storage = storage;
+    iter->pattern = librdf_new_statement_from_statement(statement);
+    iter->statement = librdf_new_statement(w);
+    iter->context = context_node;
+    iter->prepStatementIndex = ids.qindex;
+    metrics::ScopedTimer timer = db_ctx->time(db_ctx->matchStats_[ids.qindex]);
+    iter->pooled = db_ctx->acquireMatchStatement(iter->prepStatementIndex,
+                                                 &query);
+    iter->stmt = iter->pooled->st;
+    iter->it = nullptr;
+    iter->dirty = false;
+    explain_match_statement(storage, iter->prepStatementIndex);
+
+    iter->trace = start_query_trace(db_ctx);
+
+    for (unsigned int i = 0; i != ids.count; ++i) {
+        iter->stmt->setInt(i + 1, ids.parameters[i]);
+        if (iter->trace) {
+            trace_parameter(iter->trace, i + 1, nullptr, ids.parameters[i]);
+        }
+    }
+
+    iter->it = new DbStatement::Iterator(std::move(iter->stmt->iterate()));
+    iter->dirty = true;
+    trace_executed(iter);
+
+    librdf_storage_add_reference(iter->storage);
+    return librdf_new_stream(w, iter, &statement_iter_end_of_stream,
+            &statement_iter_next_statement, &statement_iter_get_statement,
+            &statement_iter_finished);
+}
+
+/**
+ * Find the statements matching a pattern. With prepareOnly the query of the
+ * pattern's shape is only prepared for later use and NULL is returned.
+ */
+static librdf_stream *find_statements(librdf_storage *storage,
+                                      librdf_statement *statement,
+                                      librdf_node *context_node,
+                                      bool prepareOnly)
 {
     Instance *db_ctx = get_instance(storage);
     librdf_world *w = get_world(storage);
 
+    if (db_ctx->unifiedNodes()) {
+        return find_unified_statements(storage, statement, context_node,
+                                       prepareOnly);
+    }
+
     /*
     SELECT r.ID as statement_id,
            rs.URI as s_uri,
@@ -1180,7 +3029,8 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
         "null as o_literal",
         "null as o_lit_lang",
         "null as o_lit_dt",
-        "c.URI as context"
+        "c.URI as context",
+        "null as o_long_literal"
     };
     assert(selectFields.size() == IDX_STATEMENT_COUNT);
 
@@ -1194,27 +3044,43 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
     librdf_node *o = librdf_statement_get_object(statement);
     size_t len;
 
-    const unsigned char *parameters[12] = {};
+    // query parameters, the ID is bound when there's no text
+    struct Parameter
+    {
+        const unsigned char *text;
+        int64_t id;
+    };
+    Parameter parameters[12] = {};
     size_t idx = 0;
 
-    // compute query index from a 3 * 2 * 6 * 2 branching
+    // with composite indexes, state the columns known to be NULL so that
+    // the bound node IDs form a usable prefix of the index keys
+    const bool composite = (db_ctx->schemaFlags_ & SCHEMA_COMPOSITE_INDEXES);
+
+    // compute query index from a 3 * 2 * 7 * 2 branching
     int qindex = 0;
-    int range = 72; // 72 = 3 * 2 * (1 + 1 + 3 + 1) * 2
+    int range = 84; // 84 = 3 * 2 * (1 + 1 + 3 + 1 + 1) * 2
 
     range /= 3; // account for three fold branching
     if (node_type(s) == LIBRDF_NODE_TYPE_RESOURCE) {
         selectFields[IDX_S_URI] = "rs.URI as s_uri";
         innerJoins.emplace_back("JOIN RESOURCE rs ON r.S_URI = rs.ID");
         whereCond.emplace_back("rs.URI=?");
+        if (composite) {
+            whereCond.emplace_back("r.S_BLANK IS NULL");
+        }
         len = 0;
-        parameters[idx++] = librdf_uri_as_counted_string(librdf_node_get_uri(s), &len);
+        parameters[idx++].text = librdf_uri_as_counted_string(librdf_node_get_uri(s), &len);
         qindex += (0 * range);
     } else if (node_type(s) == LIBRDF_NODE_TYPE_BLANK) {
         selectFields[IDX_S_BLANK] = "bs.NAME as s_blank";
         innerJoins.emplace_back("JOIN BNODE bs ON r.S_BLANK = bs.ID");
         whereCond.emplace_back("bs.NAME=?");
+        if (composite) {
+            whereCond.emplace_back("r.S_URI IS NULL");
+        }
         len = 0;
-        parameters[idx++] = librdf_node_get_counted_blank_identifier(s, &len);
+        parameters[idx++].text = librdf_node_get_counted_blank_identifier(s, &len);
         qindex += (1 * range);
     } else if (node_type(s) == LIBRDF_NODE_TYPE_LITERAL) {
         // ain't no literal a subject
@@ -1233,7 +3099,7 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
     if (node_type(p) == LIBRDF_NODE_TYPE_RESOURCE) {
         whereCond.emplace_back("rp.URI=?");
         len = 0;
-        parameters[idx++] = librdf_uri_as_counted_string(librdf_node_get_uri(p),
+        parameters[idx++].text = librdf_uri_as_counted_string(librdf_node_get_uri(p),
                                                          &len);
         qindex += (0 * range);
     } else if (node_type(p) != LIBRDF_NODE_TYPE_UNKNOWN) {
@@ -1243,29 +3109,57 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
         qindex += (1 * range);
     }
 
-    range /= 6;
-    if (node_type(o) == LIBRDF_NODE_TYPE_RESOURCE) {
+    range /= 7;
+    if (node_type(o) == LIBRDF_NODE_TYPE_LITERAL &&
+        is_long_literal(db_ctx, (const char*)
+                        librdf_node_get_literal_value(o))) {
+        // long literals can't be compared in the join, match the literal ID
+        // and take the object from the pattern
+        const int64_t oLiteral = get_pattern_node_id(storage, o);
+        if (oLiteral == 0) {
+            return impl::empty_stream::make_empty_stream(w);
+        }
+        whereCond.emplace_back("r.O_LITERAL=?");
+        if (composite) {
+            whereCond.emplace_back("r.O_URI IS NULL");
+            whereCond.emplace_back("r.O_BLANK IS NULL");
+        }
+        parameters[idx++].id = oLiteral;
+        qindex += (6 * range);
+    } else if (node_type(o) == LIBRDF_NODE_TYPE_RESOURCE) {
         selectFields[IDX_O_URI] = "ro.URI as o_uri";
         innerJoins.emplace_back("JOIN RESOURCE ro ON r.O_URI = ro.ID");
         whereCond.emplace_back("ro.URI=?");
+        if (composite) {
+            whereCond.emplace_back("r.O_BLANK IS NULL");
+            whereCond.emplace_back("r.O_LITERAL IS NULL");
+        }
         len = 0;
-        parameters[idx++] = librdf_uri_as_counted_string(librdf_node_get_uri(o),
+        parameters[idx++].text = librdf_uri_as_counted_string(librdf_node_get_uri(o),
                                                          &len);
         qindex += (0 * range);
     } else if (node_type(o) == LIBRDF_NODE_TYPE_BLANK) {
         selectFields[IDX_O_BLANK] = "bo.NAME as o_blank";
         innerJoins.emplace_back("JOIN BNODE bo ON r.O_BLANK = bo.ID");
         whereCond.emplace_back("bo.NAME=?");
+        if (composite) {
+            whereCond.emplace_back("r.O_URI IS NULL");
+            whereCond.emplace_back("r.O_LITERAL IS NULL");
+        }
         len = 0;
-        parameters[idx++] = librdf_node_get_counted_blank_identifier(o, &len);
+        parameters[idx++].text = librdf_node_get_counted_blank_identifier(o, &len);
         qindex += (1 * range);
     } else if (node_type(o) == LIBRDF_NODE_TYPE_LITERAL) {
         selectFields[IDX_O_TEXT] = "lo.VAL as o_literal";
         selectFields[IDX_O_LANGUAGE] = "lo.LANGUAGE as o_lit_lang";
         innerJoins.emplace_back("JOIN LITERAL lo ON r.O_LITERAL = lo.ID");
         whereCond.emplace_back("lo.VAL=?");
+        if (composite) {
+            whereCond.emplace_back("r.O_URI IS NULL");
+            whereCond.emplace_back("r.O_BLANK IS NULL");
+        }
         len = 0;
-        parameters[idx++] = librdf_node_get_literal_value_as_counted_string(
+        parameters[idx++].text = librdf_node_get_literal_value_as_counted_string(
                                                                        o, &len);
 
         librdf_uri *uri = librdf_node_get_literal_value_datatype_uri(o);
@@ -1278,7 +3172,7 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
         } else if (l) {
             whereCond.emplace_back("lo.LANGUAGE=?");
             whereCond.emplace_back("lo.DATATYPE IS NULL");
-            parameters[idx++] = (const unsigned char*) l;
+            parameters[idx++].text = (const unsigned char*) l;
             qindex += (3 * range);
         }
 
@@ -1289,7 +3183,7 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
             whereCond.emplace_back("lo.LANGUAGE IS NULL");
             whereCond.emplace_back("ldt.URI=?");
             len = 0;
-            parameters[idx++] = librdf_uri_as_counted_string(uri, &len);
+            parameters[idx++].text = librdf_uri_as_counted_string(uri, &len);
             qindex += (2 * range);
         }
     } else {
@@ -1298,6 +3192,10 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
         selectFields[IDX_O_TEXT] = "lo.VAL as o_literal";
         selectFields[IDX_O_LANGUAGE] = "lo.LANGUAGE as o_lit_lang";
         selectFields[IDX_O_DATATYPE] = "ldt.URI as o_lit_dt";
+        if (db_ctx->longLiterals()) {
+            selectFields[IDX_O_LONG_LITERAL] =
+                        "IIF(lo.VAL IS NULL, lo.ID, NULL) as o_long_literal";
+        }
 
         outerJoins.emplace_back("LEFT JOIN RESOURCE ro ON r.O_URI = ro.ID");
         outerJoins.emplace_back("LEFT JOIN BNODE bo ON r.O_BLANK = bo.ID");
@@ -1313,7 +3211,7 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
         innerJoins.emplace_back("JOIN CONTEXT c ON r.C_URI = c.ID");
         whereCond.emplace_back("c.URI=?");
         len = 0;
-        parameters[idx++] = librdf_uri_as_counted_string(
+        parameters[idx++].text = librdf_uri_as_counted_string(
                 librdf_node_get_uri(context_node), &len);
         qindex += (0 * range);
     } else {
@@ -1357,6 +3255,14 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
         query += *i;
     }
 
+    if (prepareOnly) {
+        Instance::PooledStatement *p = db_ctx->acquireMatchStatement(qindex,
+                                                                     &query);
+        explain_match_statement(storage, qindex);
+        db_ctx->releaseMatchStatement(qindex, p);
+        return nullptr;
+    }
+
     // create iterator
     using namespace statement_stream;
     StatementIterator *iter = LIBRDF_CALLOC(
@@ -1366,18 +3272,33 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
     iter->statement = librdf_new_statement(w);
     iter->context = context_node;
     iter->prepStatementIndex = (unsigned int) qindex;
-    iter->stmt = db_ctx->acquireMatchStatement(iter->prepStatementIndex,
-                                               (void*) iter, &query);
+    metrics::ScopedTimer timer = db_ctx->time(db_ctx->matchStats_[qindex]);
+    iter->pooled = db_ctx->acquireMatchStatement(iter->prepStatementIndex,
+                                                 &query);
+    iter->stmt = iter->pooled->st;
     iter->it = nullptr;
     iter->dirty = false;
+    explain_match_statement(storage, iter->prepStatementIndex);
+
+    iter->trace = start_query_trace(db_ctx);
 
     // bind query parameters, before creating an iterator
     for (unsigned int i = 0; i != idx; ++i) {
-        iter->stmt->setText(i + 1, (const char*) parameters[i]);
+        if (parameters[i].text) {
+            iter->stmt->setText(i + 1, (const char*) parameters[i].text);
+        } else {
+            iter->stmt->setInt(i + 1, parameters[i].id);
+        }
+        if (iter->trace) {
+            trace_parameter(iter->trace, i + 1,
+                            (const char*) parameters[i].text,
+                            parameters[i].id);
+        }
     }
 
     iter->it = new DbStatement::Iterator(std::move(iter->stmt->iterate()));
     iter->dirty = true;
+    trace_executed(iter);
 
     librdf_storage_add_reference(iter->storage);
     librdf_stream *stream = librdf_new_stream(w, iter, &statement_iter_end_of_stream,
@@ -1387,6 +3308,156 @@ static librdf_stream *pub_context_find_statements(librdf_storage *storage,
     return stream;
 }
 
+static librdf_stream *pub_context_find_statements(librdf_storage *storage,
+                                                  librdf_statement *statement,
+                                                  librdf_node *context_node)
+{
+    return find_statements(storage, statement, context_node, false);
+}
+
+/**
+ * Build a search pattern from a match shape of 3 or 4 characters, one per
+ * position: subject 'r' (resource), 'b' (blank node) or '?' (unbound),
+ * predicate 'r' or '?', object 'r', 'b', 'l' (plain literal), 'L' (literal
+ * with a language), 'd' (typed literal) or '?' and the optional context 'r'
+ * or '?'. The nodes are placeholders, only the shape matters.
+ */
+static bool make_shape_pattern(librdf_world *w, const string &shape,
+                               librdf_statement **pattern,
+                               librdf_node **context)
+{
+    static const unsigned char uri[] = "urn:x-librdf-firebird:prepare";
+    static const unsigned char blank[] = "prepare";
+
+    if (shape.size() < 3 || shape.size() > 4) {
+        return false;
+    }
+
+    librdf_node *n[4] = {nullptr, nullptr, nullptr, nullptr};
+    bool ok = true;
+    for (size_t i = 0; i != shape.size() && ok; ++i) {
+        switch (shape[i]) {
+        case '?':
+            break;
+        case 'r':
+            n[i] = librdf_new_node_from_uri_string(w, uri);
+            break;
+        case 'b':
+            ok = (i == 0 || i == 2);
+            if (ok) {
+                n[i] = librdf_new_node_from_blank_identifier(w, blank);
+            }
+            break;
+        case 'l':
+        case 'L':
+        case 'd':
+            ok = (i == 2);
+            if (ok) {
+                librdf_uri *dt = shape[i] == 'd' ?
+                                 librdf_new_uri(w, uri) : nullptr;
+                n[i] = librdf_new_node_from_typed_literal(w, blank,
+                                    shape[i] == 'L' ? "en" : nullptr, dt);
+                if (dt) {
+                    librdf_free_uri(dt);
+                }
+            }
+            break;
+        default:
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        for (librdf_node *node : n) {
+            if (node) {
+                librdf_free_node(node);
+            }
+        }
+        return false;
+    }
+
+    // the statement owns the nodes
+    *pattern = librdf_new_statement_from_nodes(w, n[0], n[1], n[2]);
+    *context = n[3];
+    return true;
+}
+
+/**
+ * Prepare all fixed statements applicable to the database schema and the
+ * match queries of the comma separated shapes (see make_shape_pattern()), so
+ * that the first queries don't pay for the prepare round trips.
+ */
+static void prepare_statements(librdf_storage *storage, const char *shapes)
+{
+    Instance *inst = get_instance(storage);
+    librdf_world *w = get_world(storage);
+    const auto start = std::chrono::steady_clock::now();
+
+    unsigned int prepared = 0;
+    unsigned int skipped = 0;
+    for (unsigned int i = 0; i != LAST_PREP_STATEMENT_IDX; ++i) {
+        const PrepStatementIndex psi = (PrepStatementIndex) i;
+        if (!prep_statement_applies(psi, inst->schemaFlags_)) {
+            // refers to schema objects this database doesn't have
+            skipped++;
+            continue;
+        }
+        try {
+            inst->getPrepStatement(psi);
+            prepared++;
+        } catch (std::exception &e) {
+            librdf_log(w, 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE, NULL,
+                       "Failed to prepare %s: %s", PREP_STATEMENT_NAMES[i],
+                       e.what());
+        }
+    }
+
+    unsigned int matchShapes = 0;
+    string list = shapes ? shapes : "";
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == string::npos) {
+            end = list.size();
+        }
+        const string shape = list.substr(pos, end - pos);
+        pos = end + 1;
+
+        librdf_statement *pattern = nullptr;
+        librdf_node *context = nullptr;
+        if (!make_shape_pattern(w, shape, &pattern, &context)) {
+            librdf_log(w, 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE, NULL,
+                       "Invalid match shape '%s'", shape.c_str());
+            continue;
+        }
+
+        try {
+            librdf_stream *stream = find_statements(storage, pattern, context,
+                                                    true);
+            if (stream) {
+                librdf_free_stream(stream);
+            }
+            matchShapes++;
+        } catch (std::exception &e) {
+            librdf_log(w, 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE, NULL,
+                       "Failed to prepare match shape '%s': %s",
+                       shape.c_str(), e.what());
+        }
+
+        librdf_free_statement(pattern);
+        if (context) {
+            librdf_free_node(context);
+        }
+    }
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+    librdf_log(w, 0, LIBRDF_LOG_INFO, LIBRDF_FROM_STORAGE, NULL,
+               "Prepared %u statements (%u not applicable to the schema) "
+               "and %u match shapes in %ld ms", prepared, skipped,
+               matchShapes, (long) ms);
+}
+
 static librdf_stream *pub_find_statements(librdf_storage *storage,
                                           librdf_statement *statement)
 {
@@ -1404,19 +3475,186 @@ static librdf_stream *pub_serialise(librdf_storage *storage)
     return pub_context_serialise(storage, NULL);
 }
 
-static inline int priv_context_add_statement(librdf_storage *storage,
-                                             int64_t context_id,
-                                             librdf_statement *statement)
+/** statements pub_context_add_statements resolves the nodes of at once */
+static const unsigned int ADD_WINDOW_SIZE = 256;
+
+/**
+ * Look up the IDs of keys (URIs, blank node names or literal values) in
+ * batches of NODE_LOOKUP_BATCH_SIZE with one of the GET_*_IDS statements.
+ * Each result row is passed to found(row).
+ */
+template<class Found>
+static void lookup_node_batches(Instance *ctx, PrepStatementIndex psi,
+                                const std::vector<string> &keys, bool hashed,
+                                Found found)
 {
-    assert(storage);
-    assert(statement);
-    return find_statement(storage, context_id, statement, true) ? RET_OK :
-                                                                  RET_ERROR;
+    for (size_t first = 0; first < keys.size();
+            first += NODE_LOOKUP_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(keys.size() - first,
+                                              NODE_LOOKUP_BATCH_SIZE);
+        DbStatement *st = ctx->getPrepStatement(psi);
+        metrics::ScopedTimer timer = ctx->timeStatement();
+        for (unsigned int i = 0; i != NODE_LOOKUP_BATCH_SIZE; ++i) {
+            // repeat the last key to fill a partial batch
+            const string &key = keys[first + (i < count ? i : count - 1)];
+            if (hashed) {
+                st->setInt(i + 1, node_hash(key.data(), key.size()));
+            } else {
+                st->setText(i + 1, key.c_str());
+            }
+        }
+        for (DbStatement::Iterator i = st->iterate(); i != st->end(); ++i) {
+            found(*i);
+        }
+    }
 }
 
-static int pub_context_add_statement(librdf_storage *storage,
-                                     librdf_node *context_node,
-                                     librdf_statement *statement)
+/**
+ * Resolve a window of nodes with one query per node table and batch of keys,
+ * insert the missing nodes and record all their IDs in the instance's
+ * NodeWindow, where find_statement_terms() takes them from.
+ */
+static void resolve_window_terms(librdf_storage *storage,
+                                 const NodeTerm *terms, size_t count)
+{
+    Instance *ctx = get_instance(storage);
+    NodeWindow &nw = ctx->nodeWindow_;
+    nw.clear();
+
+    // the unique keys of each kind, in order of appearance
+    std::vector<string> keys[NODE_KIND_LITERAL + 1];
+    std::vector<const NodeTerm*> literals;
+
+    auto addKey = [&nw, &keys] (NodeKind kind, const char *key) {
+        if (nw.ids[kind].emplace(key, 0).second) {
+            keys[kind].emplace_back(key);
+        }
+    };
+
+    for (size_t i = 0; i != count; ++i) {
+        const NodeTerm &t = terms[i];
+        if (t.kind != NODE_KIND_LITERAL) {
+            addKey(t.kind, t.value);
+            continue;
+        }
+        if (is_long_literal(ctx, t.value)) {
+            // looked up one by one through VAL_BLOB
+            continue;
+        }
+        if (t.datatype) {
+            addKey(NODE_KIND_RESOURCE, t.datatype);
+        }
+        const string key = literal_window_key(t.value, t.lang, t.datatype);
+        if (nw.ids[NODE_KIND_LITERAL].emplace(key, 0).second) {
+            keys[NODE_KIND_LITERAL].emplace_back(t.value);
+            literals.push_back(&t);
+        }
+    }
+
+    const bool hashed = ctx->hashLookup();
+    lookup_node_batches(ctx, hashed ? GET_RESOURCE_IDS_HASH : GET_RESOURCE_IDS,
+                        keys[NODE_KIND_RESOURCE], hashed,
+                        [&nw] (fb::DbRowProxy row) {
+        auto i = nw.ids[NODE_KIND_RESOURCE].find(row.getText(1));
+        if (i != nw.ids[NODE_KIND_RESOURCE].end()) {
+            i->second = row.getInt64(0);
+        }
+    });
+
+    lookup_node_batches(ctx, GET_BNODE_IDS, keys[NODE_KIND_BLANK], false,
+                        [&nw] (fb::DbRowProxy row) {
+        auto i = nw.ids[NODE_KIND_BLANK].find(row.getText(1));
+        if (i != nw.ids[NODE_KIND_BLANK].end()) {
+            i->second = row.getInt64(0);
+        }
+    });
+
+    // several literals may share a value, the batch holds each value once
+    std::vector<string> values;
+    std::unordered_set<string> seen;
+    for (const string &v : keys[NODE_KIND_LITERAL]) {
+        if (seen.insert(v).second) {
+            values.push_back(v);
+        }
+    }
+    lookup_node_batches(ctx, hashed ? GET_LITERAL_IDS_HASH : GET_LITERAL_IDS,
+                        values, hashed, [&nw] (fb::DbRowProxy row) {
+        if (row.fieldIsNull(1)) {
+            // a long literal with a colliding hash
+            return;
+        }
+        const string value = row.getText(1);
+        const string lang = row.fieldIsNull(2) ? "" : row.getText(2);
+        const string dt = row.fieldIsNull(3) ? "" : row.getText(3);
+        auto i = nw.ids[NODE_KIND_LITERAL].find(literal_window_key(
+                        value.c_str(), lang.empty() ? nullptr : lang.c_str(),
+                        dt.empty() ? nullptr : dt.c_str()));
+        if (i != nw.ids[NODE_KIND_LITERAL].end()) {
+            i->second = row.getInt64(0);
+        }
+    });
+
+    // insert the missing nodes, resources first as literal datatypes
+    nw.active = true;
+    for (const string &uri : keys[NODE_KIND_RESOURCE]) {
+        int64_t &id = nw.ids[NODE_KIND_RESOURCE][uri];
+        if (!id) {
+            id = add_resource(storage, uri.c_str());
+            nw.inserted[NODE_KIND_RESOURCE].insert(id);
+        }
+    }
+    for (const string &name : keys[NODE_KIND_BLANK]) {
+        int64_t &id = nw.ids[NODE_KIND_BLANK][name];
+        if (!id) {
+            id = add_blank(storage, name.c_str());
+            nw.inserted[NODE_KIND_BLANK].insert(id);
+        }
+    }
+    for (const NodeTerm *l : literals) {
+        int64_t &id = nw.ids[NODE_KIND_LITERAL][
+                            literal_window_key(l->value, l->lang, l->datatype)];
+        if (!id) {
+            id = add_literal(storage, l->value, l->lang, l->datatype);
+            nw.inserted[NODE_KIND_LITERAL].insert(id);
+        }
+    }
+}
+
+/** resolve_window_terms() for the nodes of a window of statements */
+static void resolve_window_nodes(librdf_storage *storage,
+                                 librdf_statement * const *window,
+                                 unsigned int count)
+{
+    std::vector<NodeTerm> terms;
+    terms.reserve(count * 3);
+    NodeTerm t;
+    for (unsigned int i = 0; i != count; ++i) {
+        if (node_term(librdf_statement_get_subject(window[i]), t)) {
+            terms.push_back(t);
+        }
+        if (node_term(librdf_statement_get_predicate(window[i]), t)) {
+            terms.push_back(t);
+        }
+        if (node_term(librdf_statement_get_object(window[i]), t)) {
+            terms.push_back(t);
+        }
+    }
+    resolve_window_terms(storage, terms.data(), terms.size());
+}
+
+static inline int priv_context_add_statement(librdf_storage *storage,
+                                             int64_t context_id,
+                                             librdf_statement *statement)
+{
+    assert(storage);
+    assert(statement);
+    return find_statement(storage, context_id, statement, true) ? RET_OK :
+                                                                  RET_ERROR;
+}
+
+static int pub_context_add_statement(librdf_storage *storage,
+                                     librdf_node *context_node,
+                                     librdf_statement *statement)
 {
     if(!storage) {
         return RET_ERROR;
@@ -1434,6 +3672,11 @@ static int pub_context_add_statement(librdf_storage *storage,
     return priv_context_add_statement(storage, context_id, statement);
 }
 
+/**
+ * Add statements in windows of ADD_WINDOW_SIZE: the nodes of a window are
+ * resolved (and the missing ones inserted) together before its statements
+ * are added.
+ */
 static int pub_context_add_statements(librdf_storage *storage,
                                       librdf_node *context_node,
                                       librdf_stream *statement_stream)
@@ -1445,14 +3688,47 @@ static int pub_context_add_statements(librdf_storage *storage,
         context_id = get_context_node_id(storage, context_node, true);
     }
 
-    for(; !librdf_stream_end(statement_stream);
-           librdf_stream_next(statement_stream)) {
-        librdf_statement *stmt = librdf_stream_get_object(statement_stream);
-        const int rc = priv_context_add_statement(storage, context_id, stmt);
-        if(RET_OK != rc) {
-            pub_transaction_rollback(storage);
-            return rc;
+    Instance *inst = get_instance(storage);
+    std::vector<librdf_statement*> window;
+    window.reserve(ADD_WINDOW_SIZE);
+    int rc = RET_OK;
+    try {
+        while (rc == RET_OK && !librdf_stream_end(statement_stream)) {
+            // the stream's statement is only valid until the next one
+            for(; window.size() != ADD_WINDOW_SIZE &&
+                   !librdf_stream_end(statement_stream);
+                   librdf_stream_next(statement_stream)) {
+                window.push_back(librdf_new_statement_from_statement(
+                            librdf_stream_get_object(statement_stream)));
+            }
+
+            resolve_window_nodes(storage, window.data(),
+                                 (unsigned int) window.size());
+            for (librdf_statement *&stmt : window) {
+                if (rc == RET_OK) {
+                    rc = priv_context_add_statement(storage, context_id, stmt);
+                }
+                librdf_free_statement(stmt);
+                stmt = nullptr;
+            }
+            window.clear();
+            inst->nodeWindow_.clear();
         }
+    } catch (std::exception &e) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE,
+                   NULL, "Failed to add statements: %s", e.what());
+        for (librdf_statement *stmt : window) {
+            if (stmt) {
+                librdf_free_statement(stmt);
+            }
+        }
+        inst->nodeWindow_.clear();
+        rc = RET_ERROR;
+    }
+
+    if(RET_OK != rc) {
+        pub_transaction_rollback(storage);
+        return rc;
     }
 
     return pub_transaction_commit(storage);
@@ -1472,6 +3748,99 @@ static int pub_add_statements(librdf_storage *storage,
     return pub_context_add_statements(storage, NULL, statement_stream);
 }
 
+/** commit a file load after this many windows, unless in a transaction */
+static const unsigned int LOAD_COMMIT_WINDOWS = 64;
+
+/**
+ * Add the statements of an N-Triples or N-Quads file in windows of
+ * ADD_WINDOW_SIZE like pub_context_add_statements(), but straight from the
+ * parsed text without librdf nodes. Statements without a graph are added
+ * to context_node (to no context if it is NULL). Outside a transaction
+ * started by librdf_storage_transaction_start() every LOAD_COMMIT_WINDOWS
+ * windows are committed. Return the number of statements added, the caller
+ * commits or rolls back the rest.
+ */
+static int64_t load_ntriples_file(librdf_storage *storage,
+                                  const char *file_name,
+                                  librdf_node *context_node)
+{
+    Instance *inst = get_instance(storage);
+
+    // the blank node labels of a file are scoped to this load: the ID of
+    // the current transaction is unique in the database, the counter within
+    // a transaction of this process
+    static std::atomic<unsigned int> loads{0};
+    DbStatement trst = inst->db_.createStatement(
+                        "SELECT CURRENT_TRANSACTION FROM RDB$DATABASE",
+                        &inst->tr_);
+    const string blankPrefix = "nt" +
+            std::to_string((long long) trst.uniqueResult().getInt64(0)) +
+            "x" + std::to_string(++loads) + "_";
+
+    NTriplesReader reader(file_name, blankPrefix);
+    const bool commitWindows = !inst->userTransaction_;
+    pub_transaction_start(storage);
+
+    int64_t default_context_id = 0;
+    if (context_node) {
+        default_context_id = get_context_node_id(storage, context_node, true);
+    }
+
+    // the context IDs of the graphs named in the file
+    std::unordered_map<string, int64_t> graphs;
+    std::vector<NodeQuad> window;
+    std::vector<NodeTerm> terms;
+    terms.reserve(ADD_WINDOW_SIZE * 3);
+    int64_t count = 0;
+    unsigned int windows = 0;
+    try {
+        while (reader.read(window, ADD_WINDOW_SIZE)) {
+            terms.clear();
+            for (const NodeQuad &q : window) {
+                terms.push_back(q.subject);
+                terms.push_back(q.predicate);
+                terms.push_back(q.object);
+            }
+            resolve_window_terms(storage, terms.data(), terms.size());
+
+            for (const NodeQuad &q : window) {
+                int64_t context_id = default_context_id;
+                if (q.graph) {
+                    auto g = graphs.find(q.graph);
+                    if (g == graphs.end()) {
+                        int64_t id = get_context_id(storage, q.graph);
+                        if (id == 0) {
+                            id = add_context(storage, q.graph);
+                        }
+                        g = graphs.emplace(q.graph, id).first;
+                    }
+                    context_id = g->second;
+                }
+                if (!find_statement_terms(storage, context_id, q.subject,
+                                          q.predicate, q.object, true)) {
+                    throw std::runtime_error("Failed to add a statement "
+                            "before line " + std::to_string(reader.line()));
+                }
+            }
+            count += window.size();
+            inst->nodeWindow_.clear();
+
+            if (commitWindows && ++windows % LOAD_COMMIT_WINDOWS == 0) {
+                if (pub_transaction_commit(storage) != RET_OK) {
+                    throw std::runtime_error("Failed to commit the "
+                            "statements before line " +
+                            std::to_string(reader.line()));
+                }
+                pub_transaction_start(storage);
+            }
+        }
+    } catch (...) {
+        inst->nodeWindow_.clear();
+        throw;
+    }
+    return count;
+}
+
 static int pub_context_remove_statement(librdf_storage *storage,
                                         librdf_node *context_node,
                                         librdf_statement *statement)
@@ -1484,7 +3853,9 @@ static int pub_context_remove_statement(librdf_storage *storage,
         }
     }
 
-    int64_t statementId = find_statement(storage, context_id, statement, false);
+    TripleKey key{0, 0, 0, 0};
+    int64_t statementId = find_statement(storage, context_id, statement, false,
+                                         &key);
 
     if (!statementId) {
         return RET_ERROR;
@@ -1492,8 +3863,13 @@ static int pub_context_remove_statement(librdf_storage *storage,
 
     Instance *inst = get_instance(storage);
     DbStatement *st = inst->getPrepStatement(DELETE_TRIPLE);
+    metrics::ScopedTimer timer = inst->timeStatement();
     st->setInt(1, statementId);
     st->execute();
+    inst->triplesChanged(1);
+    if (inst->fastLoad_) {
+        inst->loadedTriples_.erase(key);
+    }
 
     return RET_OK;
 }
@@ -1504,22 +3880,328 @@ static int pub_remove_statement(librdf_storage *storage, librdf_statement *state
     return pub_context_remove_statement(storage, NULL, statement);
 }
 
-static int pub_context_remove_statements(librdf_storage * /* storage */,
-                                         librdf_node * /* context_node */)
+/**
+ * Remove all statements of a context (or those without a context if
+ * context_node is NULL) with set based deletes. The statements are deleted
+ * in batches, which are committed unless the storage is in a transaction
+ * started with librdf_storage_transaction_start(), so that huge contexts
+ * don't build up one huge transaction.
+ */
+static int pub_context_remove_statements(librdf_storage *storage,
+                                         librdf_node *context_node)
+{
+    static const int64_t CONTEXT_REMOVE_BATCH = 100000;
+
+    Instance *inst = get_instance(storage);
+    try {
+        int64_t context_id = 0;
+        if (context_node) {
+            context_id = get_context_node_id(storage, context_node, false);
+            if (!context_id) {
+                // no such context, nothing to remove
+                return RET_OK;
+            }
+        }
+
+        for (;;) {
+            DbStatement *st = inst->getPrepStatement(context_id ?
+                                        DELETE_CONTEXT_TRIPLES :
+                                        DELETE_DEFAULT_CONTEXT_TRIPLES);
+            unsigned int n = 1;
+            if (context_id) {
+                st->setInt(n++, context_id);
+            }
+            st->setInt(n, CONTEXT_REMOVE_BATCH);
+            const int64_t deleted = st->uniqueResult().getInt64(0);
+            if (deleted == 0) {
+                break;
+            }
+            inst->invalidateLoadedTriples();
+
+            inst->triplesChanged((unsigned int) deleted);
+            if (!inst->userTransaction_) {
+                compact_triple_count_if_needed(storage);
+                inst->tr_.commitRetain();
+            }
+            if (deleted < CONTEXT_REMOVE_BATCH) {
+                break;
+            }
+        }
+
+        if (inst->removeOrphanNodes_) {
+            delete_orphan_nodes(storage);
+            if (!inst->userTransaction_) {
+                inst->tr_.commitRetain();
+            }
+        }
+    } catch (std::exception &e) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE,
+                   NULL, "Failed to remove context statements: %s", e.what());
+        return RET_ERROR;
+    }
+
+    return RET_OK;
+}
+
+/**
+ * Delete the statements matching a pattern with a single DELETE, the bound
+ * nodes are resolved to IDs first like in find_unified_statements. Like
+ * pub_context_remove_statements() a NULL context_node means the statements
+ * without a context. A pattern binding no node is refused, emptying a
+ * context is pub_context_remove_statements()' job.
+ */
+static void remove_matching_statements(librdf_storage *storage,
+                                       librdf_statement *pattern,
+                                       librdf_node *context_node)
+{
+    if (!librdf_statement_get_subject(pattern) &&
+        !librdf_statement_get_predicate(pattern) &&
+        !librdf_statement_get_object(pattern)) {
+        throw std::invalid_argument("the pattern matches every statement, "
+                    "use librdf_storage_context_remove_statements()");
+    }
+
+    PatternIds ids;
+    if (!get_pattern_ids(storage, pattern, context_node, ids)) {
+        return;
+    }
+
+    // an EXECUTE BLOCK like DELETE_CONTEXT_TRIPLES, to learn the number of
+    // deleted rows; the ? of the pattern become its parameters P1, P2...
+    string params;
+    string where;
+    unsigned int n = 0;
+    // skip the leading " AND "
+    for (string::size_type i = 4; i < ids.where.size(); ++i) {
+        if (ids.where[i] != '?') {
+            where += ids.where[i];
+            continue;
+        }
+        const string name = "P" + std::to_string(++n);
+        params += (n > 1 ? ", " : "") + name + " BIGINT = ?";
+        where += ":" + name;
+    }
+    assert(n == ids.count && n > 0);
+    if (!context_node) {
+        where += " AND r.C_URI IS NULL";
+    }
+
+    const string query = "EXECUTE BLOCK (" + params + ") "
+                         "RETURNS (DELETED BIGINT) AS "
+                         "BEGIN "
+                         "DELETE FROM TRIPLE r WHERE " + where + "; "
+                         "DELETED = ROW_COUNT; "
+                         "SUSPEND; "
+                         "END";
+
+    Instance *inst = get_instance(storage);
+    DbStatement st = inst->db_.createStatement(query.c_str(), &inst->tr_);
+    for (unsigned int i = 0; i != ids.count; ++i) {
+        st.setInt(i + 1, ids.parameters[i]);
+    }
+    const int64_t deleted = st.uniqueResult().getInt64(0);
+    if (deleted > 0) {
+        inst->invalidateLoadedTriples();
+        inst->triplesChanged((unsigned int) deleted);
+    }
+}
+
+/** delete the first count statements of ids with one DELETE_TRIPLE_BATCH */
+static void delete_statement_batch(Instance *inst, const int64_t *ids,
+                                   unsigned int count)
+{
+    assert(0 < count && count <= DELETE_TRIPLE_BATCH_SIZE);
+    DbStatement *st = inst->getPrepStatement(DELETE_TRIPLE_BATCH);
+    metrics::ScopedTimer timer = inst->timeStatement();
+    for (unsigned int i = 0; i != DELETE_TRIPLE_BATCH_SIZE; ++i) {
+        // repeat the last ID to fill a partial batch
+        st->setInt(i + 1, ids[i < count ? i : count - 1]);
+    }
+    st->execute();
+    inst->triplesChanged(count);
+}
+
+/**
+ * Delete the statements of a stream, their IDs are looked up one by one but
+ * deleted in batches of DELETE_TRIPLE_BATCH_SIZE. Statements which don't
+ * exist are skipped.
+ */
+static void remove_stream_statements(librdf_storage *storage,
+                                     librdf_stream *statement_stream,
+                                     librdf_node *context_node)
+{
+    int64_t context_id = 0;
+    if (context_node) {
+        context_id = get_context_node_id(storage, context_node, false);
+        if (!context_id) {
+            // no such context, nothing to remove
+            return;
+        }
+    }
+
+    Instance *inst = get_instance(storage);
+    int64_t ids[DELETE_TRIPLE_BATCH_SIZE];
+    unsigned int count = 0;
+
+    for(; !librdf_stream_end(statement_stream);
+           librdf_stream_next(statement_stream)) {
+        librdf_statement *stmt = librdf_stream_get_object(statement_stream);
+        TripleKey key{0, 0, 0, 0};
+        const int64_t id = find_statement(storage, context_id, stmt, false,
+                                          &key);
+        if (!id) {
+            continue;
+        }
+        if (std::find(ids, ids + count, id) != ids + count) {
+            // repeated in this batch, it is deleted and counted once
+            continue;
+        }
+        if (inst->fastLoad_) {
+            inst->loadedTriples_.erase(key);
+        }
+
+        ids[count++] = id;
+        if (count == DELETE_TRIPLE_BATCH_SIZE) {
+            delete_statement_batch(inst, ids, count);
+            count = 0;
+        }
+    }
+
+    if (count) {
+        delete_statement_batch(inst, ids, count);
+    }
+}
+
+/** 0 based index into the GET_TRIPLE_LOG_CHANGES result */
+enum idx_triple_log_column_t : int
+{
+    IDX_LOG_SEQ = 0,
+    IDX_LOG_OP,
+    IDX_LOG_S_URI,
+    IDX_LOG_S_BLANK,
+    IDX_LOG_P_URI,
+    IDX_LOG_O_URI,
+    IDX_LOG_O_BLANK,
+    IDX_LOG_O_TEXT,
+    IDX_LOG_O_LANGUAGE,
+    IDX_LOG_O_DATATYPE,
+    IDX_LOG_C_URI,
+    IDX_LOG_O_LONG_LITERAL
+};
+
+static void require_triple_log(Instance *inst)
+{
+    if (!inst->tripleLog()) {
+        throw std::runtime_error("the database has no change log, it is "
+                                 "created with triple_log='yes'");
+    }
+}
+
+/**
+ * Pass up to maxChanges of the changes logged after the sequence number
+ * since to handler, in sequence order, until it returns non-zero. Return
+ * the sequence number of the last change passed, since if there were none.
+ */
+static int64_t read_logged_changes(librdf_storage *storage, int64_t since,
+                        unsigned int maxChanges,
+                        librdf_storage_firebird_change_handler handler,
+                        void *user_data)
+{
+    Instance *inst = get_instance(storage);
+    require_triple_log(inst);
+    librdf_world *w = get_world(storage);
+
+    DbStatement *st = inst->getPrepStatement(GET_TRIPLE_LOG_CHANGES);
+    metrics::ScopedTimer timer = inst->timeStatement();
+    st->setInt(1, maxChanges);
+    st->setInt(2, since);
+
+    int64_t last = since;
+    for (DbStatement::Iterator i = st->iterate(); i != st->end(); ++i) {
+        fb::DbRowProxy row = *i;
+        const int64_t seq = row.getInt64(IDX_LOG_SEQ);
+        const int op = (int) row.getInt64(IDX_LOG_OP);
+        const bool sBlank = row.fieldIsNull(IDX_LOG_S_URI);
+        const string subject = row.getText(sBlank ? IDX_LOG_S_BLANK :
+                                                    IDX_LOG_S_URI);
+        const string predicate = row.getText(IDX_LOG_P_URI);
+        const bool oUri = !row.fieldIsNull(IDX_LOG_O_URI);
+        const bool oBlank = !row.fieldIsNull(IDX_LOG_O_BLANK);
+        string object = row.getText(oUri ? IDX_LOG_O_URI :
+                                    oBlank ? IDX_LOG_O_BLANK :
+                                             IDX_LOG_O_TEXT);
+        if (!oUri && !oBlank && !row.fieldIsNull(IDX_LOG_O_LONG_LITERAL)) {
+            object = statement_stream::get_long_literal_value(storage,
+                                    row.getInt64(IDX_LOG_O_LONG_LITERAL));
+        }
+        const string lang = row.getText(IDX_LOG_O_LANGUAGE);
+        const string datatype = row.getText(IDX_LOG_O_DATATYPE);
+        const bool hasContext = !row.fieldIsNull(IDX_LOG_C_URI);
+        const string context = row.getText(IDX_LOG_C_URI);
+
+        librdf_node *s = sBlank ?
+                librdf_new_node_from_blank_identifier(w,
+                                    (const unsigned char*) subject.c_str()) :
+                librdf_new_node_from_uri_string(w,
+                                    (const unsigned char*) subject.c_str());
+        librdf_node *p = librdf_new_node_from_uri_string(w,
+                                    (const unsigned char*) predicate.c_str());
+        librdf_node *o;
+        if (oUri) {
+            o = librdf_new_node_from_uri_string(w,
+                                    (const unsigned char*) object.c_str());
+        } else if (oBlank) {
+            o = librdf_new_node_from_blank_identifier(w,
+                                    (const unsigned char*) object.c_str());
+        } else {
+            librdf_uri *dt = datatype.empty() ? nullptr :
+                    librdf_new_uri(w, (const unsigned char*) datatype.c_str());
+            o = librdf_new_node_from_typed_literal(w,
+                                    (const unsigned char*) object.c_str(),
+                                    lang.empty() ? nullptr : lang.c_str(), dt);
+            if (dt) {
+                librdf_free_uri(dt);
+            }
+        }
+        // the statement owns the nodes
+        librdf_statement *stmt = librdf_new_statement_from_nodes(w, s, p, o);
+        librdf_node *c = hasContext ?
+                librdf_new_node_from_uri_string(w,
+                                    (const unsigned char*) context.c_str()) :
+                nullptr;
+
+        const int stop = handler(user_data, seq, op, stmt, c);
+        librdf_free_statement(stmt);
+        if (c) {
+            librdf_free_node(c);
+        }
+        last = seq;
+        if (stop) {
+            break;
+        }
+    }
+    return last;
+}
+
+/** the sequence number of the last logged change */
+static int64_t get_change_watermark(librdf_storage *storage)
 {
-    assert(!"Not implemented");
-    return RET_ERROR; // TODO: implement this
-//    n = transaction_start(storage);
-//    for(librdf_statement *stmt = librdf_stream_get_object(statement_stream);
-//            !librdf_stream_end(statement_stream);
-//            librdf_stream_next(statement_stream) ) {
-//        const int rc = pub_context_remove_statement(storage, context_node, stmt);
-//        if( RET_OK != rc ) {
-//            transaction_rollback(storage, txn);
-//            return rc;
-//        }
-//    }
-//    return transaction_commit(storage, txn);
+    Instance *inst = get_instance(storage);
+    require_triple_log(inst);
+    DbStatement *st = inst->getPrepStatement(GET_TRIPLE_LOG_WATERMARK);
+    metrics::ScopedTimer timer = inst->timeStatement();
+    return st->uniqueResult().getInt64(0);
+}
+
+/** delete the logged changes up to and including the sequence number */
+static void trim_logged_changes(librdf_storage *storage, int64_t watermark)
+{
+    Instance *inst = get_instance(storage);
+    require_triple_log(inst);
+    DbStatement *st = inst->getPrepStatement(TRIM_TRIPLE_LOG);
+    metrics::ScopedTimer timer = inst->timeStatement();
+    st->setInt(1, watermark);
+    st->execute();
 }
 
 
@@ -1528,7 +4210,9 @@ static int pub_context_remove_statements(librdf_storage * /* storage */,
 
 static void register_factory(librdf_storage_factory *factory)
 {
-    assert(!strcmp(factory->name, LIBRDF_STORAGE_FIREBIRD));
+    // registered under both names, see librdf_init_storage_firebird()
+    assert(!strcmp(factory->name, LIBRDF_STORAGE_FIREBIRD) ||
+           !strcmp(factory->name, LIBRDF_STORAGE_FIREBIRD_SHORT));
 
     factory->version                    = LIBRDF_STORAGE_INTERFACE_VERSION;
     factory->init                       = pub_init;
@@ -1559,6 +4243,199 @@ static void register_factory(librdf_storage_factory *factory)
 
 void librdf_init_storage_firebird(librdf_world *world)
 {
-    librdf_storage_register_factory(world, LIBRDF_STORAGE_FIREBIRD,
-                                    "Firebird", &rdf::register_factory);
+    for (const char *name : { LIBRDF_STORAGE_FIREBIRD,
+                              LIBRDF_STORAGE_FIREBIRD_SHORT }) {
+        // skip the names registered already, e.g. by librdf loading the
+        // module
+        if (!librdf_get_storage_factory(world, name)) {
+            librdf_storage_register_factory(world, name, "Firebird",
+                                            &rdf::register_factory);
+        }
+    }
+}
+
+void librdf_storage_module_register_factory(librdf_world *world)
+{
+    librdf_init_storage_firebird(world);
+}
+
+int64_t librdf_storage_firebird_get_size(librdf_storage *storage)
+{
+    try {
+        return rdf::impl::get_triple_count(storage);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to count statements: %s", e.what());
+        return -1;
+    }
+}
+
+int librdf_storage_firebird_remove_matching(librdf_storage *storage,
+                                            librdf_statement *pattern,
+                                            librdf_node *context)
+{
+    try {
+        rdf::remove_matching_statements(storage, pattern, context);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to remove matching statements: %s", e.what());
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+int librdf_storage_firebird_remove_statements(librdf_storage *storage,
+                                              librdf_stream *statements,
+                                              librdf_node *context)
+{
+    try {
+        rdf::remove_stream_statements(storage, statements, context);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to remove statements: %s", e.what());
+        rdf::pub_transaction_rollback(storage);
+        return RET_ERROR;
+    }
+    return rdf::pub_transaction_commit(storage);
+}
+
+int64_t librdf_storage_firebird_collect_garbage(librdf_storage *storage,
+                                              unsigned int max_nodes)
+{
+    int64_t deleted = -1;
+    try {
+        deleted = rdf::impl::collect_orphan_nodes(storage, max_nodes);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to collect unused nodes: %s", e.what());
+        rdf::pub_transaction_rollback(storage);
+        return -1;
+    }
+    return rdf::pub_transaction_commit(storage) == RET_OK ? deleted : -1;
+}
+
+int64_t librdf_storage_firebird_get_context_size(librdf_storage *storage,
+                                                 librdf_node *context)
+{
+    if (rdf::impl::node_type(context) != LIBRDF_NODE_TYPE_RESOURCE) {
+        return -1;
+    }
+
+    try {
+        return rdf::impl::get_context_triple_count(storage, context);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to count context statements: %s", e.what());
+        return -1;
+    }
+}
+
+int librdf_storage_firebird_get_statement_pool_stats(
+                        librdf_storage *storage, unsigned int qindex,
+                        librdf_storage_firebird_statement_pool_stats *stats)
+{
+    using rdf::impl::MatchPreparedStatement;
+    using rdf::impl::MatchPreparedStatements;
+
+    if (qindex >= MatchPreparedStatements::MATCH_STATEMENTS_COUNT || !stats) {
+        return RET_ERROR;
+    }
+
+    const MatchPreparedStatement &mps =
+                rdf::impl::get_instance(storage)->matchStatements_.get(qindex);
+    stats->prepares = mps.prepares;
+    stats->reuses = mps.reuses;
+    stats->in_use = mps.inUse;
+    stats->idle = (unsigned int) mps.idle.size();
+    stats->peak_in_use = mps.peakInUse;
+    return RET_OK;
+}
+
+unsigned int librdf_storage_firebird_get_statement_pool_count(void)
+{
+    return rdf::impl::MatchPreparedStatements::MATCH_STATEMENTS_COUNT;
+}
+
+int64_t librdf_storage_firebird_load_file(librdf_storage *storage,
+                                          const char *file_name,
+                                          librdf_node *context)
+{
+    if (!file_name || (context && rdf::impl::node_type(context) !=
+                                  LIBRDF_NODE_TYPE_RESOURCE)) {
+        return -1;
+    }
+
+    int64_t count = -1;
+    try {
+        count = rdf::load_ntriples_file(storage, file_name, context);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to load %s: %s", file_name, e.what());
+        rdf::pub_transaction_rollback(storage);
+        return -1;
+    }
+    return rdf::pub_transaction_commit(storage) == RET_OK ? count : -1;
+}
+
+int64_t librdf_storage_firebird_get_changes(librdf_storage *storage,
+                        int64_t since, unsigned int max_changes,
+                        librdf_storage_firebird_change_handler handler,
+                        void *user_data)
+{
+    if (!handler || since < 0) {
+        return -1;
+    }
+
+    try {
+        return rdf::read_logged_changes(storage, since, max_changes, handler,
+                                        user_data);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to read the change log: %s", e.what());
+        return -1;
+    }
+}
+
+int64_t librdf_storage_firebird_get_change_watermark(librdf_storage *storage)
+{
+    try {
+        return rdf::get_change_watermark(storage);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to read the change log: %s", e.what());
+        return -1;
+    }
+}
+
+int librdf_storage_firebird_trim_changes(librdf_storage *storage,
+                                         int64_t watermark)
+{
+    try {
+        rdf::trim_logged_changes(storage, watermark);
+    } catch (std::exception &e) {
+        librdf_log(rdf::impl::get_world(storage), 0, LIBRDF_LOG_ERROR,
+                   LIBRDF_FROM_STORAGE, NULL,
+                   "Failed to trim the change log: %s", e.what());
+        rdf::pub_transaction_rollback(storage);
+        return RET_ERROR;
+    }
+    return rdf::pub_transaction_commit(storage);
+}
+
+char *librdf_storage_firebird_get_stats(librdf_storage *storage)
+{
+    const std::string stats = rdf::format_stats(storage);
+    char *copy = (char*) malloc(stats.size() + 1);
+    if (copy) {
+        memcpy(copy, stats.c_str(), stats.size() + 1);
+    }
+    return copy;
 }
@@ -15,12 +15,19 @@
 #define REDLAND_RDF_STORAGE_FIREBIRD_H
 
 #include <librdf.h>
+#include <stdint.h>
 
 /**
  * Factory name
  */
 extern const char * const LIBRDF_STORAGE_FIREBIRD;
 
+/**
+ * Short factory name, the one librdf loads the storage module by; both
+ * names are registered
+ */
+extern const char * const LIBRDF_STORAGE_FIREBIRD_SHORT;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -32,9 +39,170 @@ extern "C" {
  * librdf.firebird storage module by calling:
  *     librdf_new_storage(world, LIBRDF_STORAGE_FIREBIRD,
  *                        database_path, options);
+ * or with the name "firebird" (LIBRDF_STORAGE_FIREBIRD_SHORT).
  */
 void librdf_init_storage_firebird(librdf_world *world);
 
+/**
+ * Entry point of the loadable storage module: a librdf built with modular
+ * storages calls it when it loads librdf_storage_firebird from its module
+ * directory (or REDLAND_MODULE_PATH), making the storage available to
+ * programs such as rdfproc without librdf_init_storage_firebird()
+ */
+void librdf_storage_module_register_factory(librdf_world *world);
+
+/**
+ * Return the exact number of statements in a Firebird storage or -1 on
+ * error. Unlike librdf_storage_size() the count isn't truncated to an int
+ * and, if the database maintains a triple count (the triple_count storage
+ * option), it doesn't scan the TRIPLE table.
+ */
+int64_t librdf_storage_firebird_get_size(librdf_storage *storage);
+
+/**
+ * Return the number of statements in the context (a resource node) of a
+ * Firebird storage, 0 if there is no such context or -1 on error.
+ */
+int64_t librdf_storage_firebird_get_context_size(librdf_storage *storage,
+                                                 librdf_node *context);
+
+/**
+ * Remove all statements matching a pattern, in the given context or among
+ * the statements without a context if context is NULL (like
+ * librdf_storage_context_remove_statements()), with a single DELETE. The
+ * pattern must bind at least one node, a context is emptied with
+ * librdf_storage_context_remove_statements(). The removal isn't committed.
+ * Return non-zero on failure.
+ */
+int librdf_storage_firebird_remove_matching(librdf_storage *storage,
+                                            librdf_statement *pattern,
+                                            librdf_node *context);
+
+/**
+ * Remove the statements of a stream from the context (or from the
+ * statements without a context if context is NULL) deleting them in
+ * batches, and commit. Statements not in the storage are skipped. Return
+ * non-zero on failure.
+ */
+int librdf_storage_firebird_remove_statements(librdf_storage *storage,
+                                              librdf_stream *statements,
+                                              librdf_node *context);
+
+/**
+ * Delete nodes (resources, blank nodes and literals) no statement refers to.
+ * Each call examines at most max_nodes IDs of each node table, continuing
+ * where the previous call stopped, and commits. Return the number of
+ * deleted nodes or -1 on error.
+ */
+int64_t librdf_storage_firebird_collect_garbage(librdf_storage *storage,
+                                              unsigned int max_nodes);
+
+/**
+ * Add the statements of an N-Triples or N-Quads file, parsed without raptor
+ * and added like librdf_storage_context_add_statements() does, and commit.
+ * The graph of an N-Quads statement is its context, the other statements
+ * are added to context (to no context if it is NULL), blank node graph
+ * names are rejected. Blank node labels only identify nodes within the
+ * file, each call creates new blank nodes. Files ending with .gz or .zst
+ * are decompressed while they are read. Outside a transaction started by
+ * librdf_storage_transaction_start() the statements are committed in
+ * batches. Return the number of statements added or -1 on error, when the
+ * batches committed before the error are kept.
+ */
+int64_t librdf_storage_firebird_load_file(librdf_storage *storage,
+                                          const char *file_name,
+                                          librdf_node *context);
+
+/**
+ * Receives a change of librdf_storage_firebird_get_changes(): its sequence
+ * number, op 1 for an added and -1 for a removed statement, the statement
+ * and its context (NULL for none), which are freed after the call. Return
+ * non-zero to stop.
+ */
+typedef int (*librdf_storage_firebird_change_handler)(
+                        void *user_data, int64_t seq, int op,
+                        librdf_statement *statement, librdf_node *context);
+
+/**
+ * Pass up to max_changes of the changes logged after the sequence number
+ * since (0 for all) to handler, oldest first. Requires a database created
+ * with triple_log='yes'. Return the sequence number of the last change
+ * passed, the watermark to continue from (since if there were no more
+ * changes), or -1 on error.
+ *
+ * Sequence numbers are handed out when a change is made, not when it is
+ * committed, so with several writing connections a change may become
+ * visible after changes with higher numbers were read. Such consumers
+ * should read again from some way below their watermark (e.g. the changes
+ * of the longest transaction) and skip the sequence numbers they already
+ * applied.
+ */
+int64_t librdf_storage_firebird_get_changes(librdf_storage *storage,
+                        int64_t since, unsigned int max_changes,
+                        librdf_storage_firebird_change_handler handler,
+                        void *user_data);
+
+/**
+ * Return the highest sequence number of the committed changes visible to
+ * the storage's transaction, or -1 on error. Taken in the transaction of a
+ * full export (before it commits), the changes after it are those the
+ * export doesn't include, apart from those of transactions still running
+ * (see librdf_storage_firebird_get_changes()).
+ */
+int64_t librdf_storage_firebird_get_change_watermark(librdf_storage *storage);
+
+/**
+ * Delete the logged changes up to and including the watermark, once all
+ * consumers have read them, and commit. The nodes of logged changes are
+ * kept by librdf_storage_firebird_collect_garbage() until then. Return
+ * non-zero on failure.
+ */
+int librdf_storage_firebird_trim_changes(librdf_storage *storage,
+                                         int64_t watermark);
+
+/** usage of the prepared statements of one match query shape */
+typedef struct
+{
+    /** statements prepared on the server */
+    uint64_t prepares;
+    /** queries which reused an idle prepared statement */
+    uint64_t reuses;
+    /** statements used by open streams now */
+    unsigned int in_use;
+    /** prepared statements kept for reuse now */
+    unsigned int idle;
+    /** most statements used by open streams at the same time */
+    unsigned int peak_in_use;
+} librdf_storage_firebird_statement_pool_stats;
+
+/**
+ * Fill stats with the usage of the statement pool of match query shape
+ * qindex (0 based, see librdf_storage_firebird_get_statement_pool_count()).
+ * Return 0 on success, non-zero if qindex is out of range.
+ */
+int librdf_storage_firebird_get_statement_pool_stats(
+                        librdf_storage *storage, unsigned int qindex,
+                        librdf_storage_firebird_statement_pool_stats *stats);
+
+/** the number of match query shapes, each has its own statement pool */
+unsigned int librdf_storage_firebird_get_statement_pool_count(void);
+
+/**
+ * Feature URI for librdf_storage_get_feature(), the value is a literal with
+ * the text of librdf_storage_firebird_get_stats()
+ */
+#define LIBRDF_STORAGE_FIREBIRD_FEATURE_STATS \
+    "http://librdf.org/docs/api/redland-storage-module-firebird.html#stats"
+
+/**
+ * Return the operation statistics of the storage as text, to be freed with
+ * free(). Each line holds the kind of item ("statement", "match", "cache" or
+ * "operation"), its name and space separated name=value pairs: call and row
+ * counters, cache hits, misses and evictions and, unless the storage was
+ * opened with metrics='no', latency percentiles in microseconds.
+ */
+char *librdf_storage_firebird_get_stats(librdf_storage *storage);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif